@@ -4,10 +4,25 @@ Compressor::Compressor()
 {
 }
 
-void Compressor::prepare(double sampleRate, int /*samplesPerBlock*/)
+void Compressor::prepare(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    scratchBuffer.setSize(NumScratchChannels, juce::jmax(1, samplesPerBlock), false, true);
+
+    const int maxLookaheadSamples = juce::jmax(1, getLookaheadSamples(maxLookaheadMs, sampleRate));
+    lookaheadBuffer.setSize(2, maxLookaheadSamples);
+    peakCandidates.assign((size_t) maxLookaheadSamples + 1, {});
+    levelHistory.assign((size_t) maxLookaheadSamples + 1, 0.0f);
+    lookaheadSamples = std::min(getLookaheadSamples(lookaheadMs, sampleRate), maxLookaheadSamples);
+    lookaheadFadeLength = juce::jmax(1, juce::roundToInt(lookaheadFadeMs * 0.001 * sampleRate));
+
+    const int maxRMSWindowSamples = juce::jmax(1, juce::roundToInt(maxRMSWindowMs * 0.001 * sampleRate));
+    rmsSquares.assign((size_t) maxRMSWindowSamples, 0.0f);
+    rmsWindowSamples = juce::jlimit(1, maxRMSWindowSamples, juce::roundToInt(rmsWindowMs * 0.001 * sampleRate));
+
     updateCoefficients();
+    updateGainSmoothing();
+    updateGainCurve(threshold, ratio, kneeWidth);
     reset();
 }
 
@@ -18,15 +33,56 @@ void Compressor::reset()
     currentGainReduction = 0.0f;
     smoothedGainReduction = 0.0f;
     smoothedGain = 1.0f;
+    controlGain = makeupLinear;
+    controlGainStep = 0.0f;
+    samplesUntilControlPoint = 0;
+
+    lookaheadBuffer.clear();
+    lookaheadWritePosition = 0;
+    lookaheadFadeRemaining = 0;
+    peakFront = 0;
+    peakCount = 0;
+    std::fill(levelHistory.begin(), levelHistory.end(), 0.0f);
+    levelHistoryPosition = 0;
+
+    resetRMS();
+}
+
+void Compressor::resetRMS()
+{
+    std::fill(rmsSquares.begin(), rmsSquares.end(), 0.0f);
+    rmsPosition = 0;
+    rmsSum = 0.0;
+    rmsFreshSum = 0.0;
 }
 
 void Compressor::updateCoefficients()
 {
     attackCoeff = DSPUtils::calculateCoefficient(currentSampleRate, attackMs);
     releaseCoeff = DSPUtils::calculateCoefficient(currentSampleRate, releaseMs);
+    autoReleaseCoeff = DSPUtils::calculateCoefficient(currentSampleRate, releaseMs * 2.0f);
     makeupLinear = DSPUtils::decibelsToLinear(makeupGain);
 }
 
+void Compressor::updateGainSmoothing()
+{
+    // Smoothing coefficient for gain changes (prevents clicks/pops)
+    // Use a fast smoothing time of ~1ms
+    gainSmoothCoeff = DSPUtils::calculateCoefficient(currentSampleRate, 1.0f);
+
+    // At control rate the smoother steps once per interval, with the same time constant
+    if (controlInterval > 1 && ! autoRelease)
+        gainSmoothCoeff = 1.0f - std::pow(1.0f - gainSmoothCoeff, static_cast<float>(controlInterval));
+}
+
+void Compressor::restartControlRamps()
+{
+    // Start the ramps from the current gain at the next sample
+    samplesUntilControlPoint = 0;
+    controlGain = smoothedGain * makeupLinear;
+    controlGainStep = 0.0f;
+}
+
 void Compressor::setThreshold(float thresholdDb)
 {
     threshold = std::clamp(thresholdDb, -60.0f, 0.0f);
@@ -62,24 +118,148 @@ void Compressor::setKnee(float kneeDb)
 
 void Compressor::setAutoRelease(bool enabled)
 {
-    autoRelease = enabled;
+    if (enabled != autoRelease)
+    {
+        // The auto-release path doesn't advance the control-rate ramps
+        autoRelease = enabled;
+        restartControlRamps();
+        updateGainSmoothing();
+    }
+}
+
+void Compressor::setControlInterval(int numSamples)
+{
+    numSamples = std::clamp(numSamples, 1, 64);
+
+    if (numSamples != controlInterval)
+    {
+        controlInterval = numSamples;
+        restartControlRamps();
+        updateGainSmoothing();
+    }
+}
+
+void Compressor::setLookahead(float newLookaheadMs)
+{
+    lookaheadMs = std::clamp(newLookaheadMs, 0.0f, maxLookaheadMs);
+
+    const int numSamples = std::min(getLookaheadSamples(lookaheadMs, currentSampleRate),
+                                    lookaheadBuffer.getNumSamples());
+
+    if (numSamples == lookaheadSamples)
+        return;
+
+    if (lookaheadSamples == 0)
+    {
+        // The delay line and level history aren't written without lookahead,
+        // so they start again from silence
+        lookaheadBuffer.clear();
+        std::fill(levelHistory.begin(), levelHistory.end(), 0.0f);
+    }
+
+    // Both rings hold the last maxLookaheadMs whatever the length, so the
+    // delay line crossfades from the old read offset to the new one and the
+    // detector window is rebuilt over the new length from the level history
+    previousLookaheadSamples = lookaheadSamples;
+    lookaheadSamples = numSamples;
+    lookaheadFadeRemaining = lookaheadFadeLength;
+    rebuildPeakCandidates();
+}
+
+void Compressor::setDetectorBlend(float rmsAmount)
+{
+    const float newBlend = std::clamp(rmsAmount, 0.0f, 1.0f);
+
+    // The RMS window isn't updated while the detector is pure peak
+    if (detectorBlend == 0.0f && newBlend > 0.0f)
+        resetRMS();
+
+    detectorBlend = newBlend;
+}
+
+void Compressor::setRMSWindow(float windowMs)
+{
+    rmsWindowMs = std::clamp(windowMs, 1.0f, maxRMSWindowMs);
+
+    const int numSamples = juce::jlimit(1, juce::jmax(1, static_cast<int>(rmsSquares.size())),
+                                        juce::roundToInt(rmsWindowMs * 0.001 * currentSampleRate));
+
+    if (numSamples != rmsWindowSamples)
+    {
+        rmsWindowSamples = numSamples;
+        resetRMS();
+    }
+}
+
+int Compressor::getLookaheadSamples(float timeMs, double sampleRate)
+{
+    return juce::roundToInt(std::clamp(timeMs, 0.0f, maxLookaheadMs) * 0.001 * sampleRate);
 }
 
 void Compressor::setBypass(bool shouldBypass)
 {
+    // Only the delay line runs while bypassed, so the detector window, level
+    // history and RMS window start again from silence when switched back in
+    if (bypassed && ! shouldBypass)
+    {
+        peakFront = 0;
+        peakCount = 0;
+        std::fill(levelHistory.begin(), levelHistory.end(), 0.0f);
+        levelHistoryPosition = 0;
+        resetRMS();
+    }
+
     bypassed = shouldBypass;
 }
 
-float Compressor::computeGain(float inputDb)
+void Compressor::updateGainCurve(float thresholdDb, float newRatio, float kneeDb)
+{
+    // Same ranges as the setters, so the table matches the settings in use
+    thresholdDb = std::clamp(thresholdDb, -60.0f, 0.0f);
+    newRatio = std::clamp(newRatio, 1.0f, 20.0f);
+    kneeDb = std::clamp(kneeDb, 0.0f, 12.0f);
+
+    const juce::SpinLock::ScopedLockType lock(gainCurveBuildLock);
+
+    if (thresholdDb == builtThreshold && newRatio == builtRatio && kneeDb == builtKnee)
+        return;
+
+    GainCurve& curve = gainCurves.getWriteBuffer();
+    curve.threshold = thresholdDb;
+    curve.ratio = newRatio;
+    curve.kneeWidth = kneeDb;
+
+    for (int i = 0; i < GainCurve::numPoints; ++i)
+    {
+        const float inputDb = GainCurve::minDb + static_cast<float>(i) / GainCurve::pointsPerDb;
+        curve.gainReductionDb[(size_t) i] = computeStaticGain(inputDb, thresholdDb, newRatio, kneeDb);
+    }
+
+    gainCurves.publish();
+
+    builtThreshold = thresholdDb;
+    builtRatio = newRatio;
+    builtKnee = kneeDb;
+}
+
+float Compressor::computeGain(float inputDb) const
+{
+    if (activeCurve != nullptr)
+        return activeCurve->lookup(inputDb);
+
+    return computeStaticGain(inputDb, threshold, ratio, kneeWidth);
+}
+
+float Compressor::computeStaticGain(float inputDb, float thresholdDb, float curveRatio, float kneeWidthDb)
 {
     // Soft knee compression
     float gainReductionDb = 0.0f;
 
-    if (kneeWidth > 0.0f)
+    if (kneeWidthDb > 0.0f)
     {
         // Soft knee region
-        float kneeStart = threshold - kneeWidth / 2.0f;
-        float kneeEnd = threshold + kneeWidth / 2.0f;
+        float kneeStart = thresholdDb - kneeWidthDb / 2.0f;
+        float kneeEnd = thresholdDb + kneeWidthDb / 2.0f;
 
         if (inputDb <= kneeStart)
         {
@@ -89,14 +269,14 @@ float Compressor::computeGain(float inputDb)
         else if (inputDb >= kneeEnd)
         {
             // Above knee - full compression
-            float overDb = inputDb - threshold;
-            gainReductionDb = overDb * (1.0f - 1.0f / ratio);
+            float overDb = inputDb - thresholdDb;
+            gainReductionDb = overDb * (1.0f - 1.0f / curveRatio);
         }
         else
         {
             // In knee region - interpolate
-            float kneeProgress = (inputDb - kneeStart) / kneeWidth;
-            float softRatio = 1.0f + (ratio - 1.0f) * kneeProgress;
+            float kneeProgress = (inputDb - kneeStart) / kneeWidthDb;
+            float softRatio = 1.0f + (curveRatio - 1.0f) * kneeProgress;
             float overDb = inputDb - kneeStart;
             gainReductionDb = overDb * (1.0f - 1.0f / softRatio) * kneeProgress;
         }
@@ -104,21 +284,18 @@ float Compressor::computeGain(float inputDb)
     else
     {
         // Hard knee
-        if (inputDb > threshold)
+        if (inputDb > thresholdDb)
         {
-            float overDb = inputDb - threshold;
-            gainReductionDb = overDb * (1.0f - 1.0f / ratio);
+            float overDb = inputDb - thresholdDb;
+            gainReductionDb = overDb * (1.0f - 1.0f / curveRatio);
         }
     }
 
     return gainReductionDb;
 }
 
-float Compressor::processSample(float inputL, float inputR, float& envL, float& envR)
+float Compressor::processSample(float inputLevel, float& envL, float& envR)
 {
-    // Get input level (max of stereo channels for linked compression)
-    float inputLevel = std::max(std::abs(inputL), std::abs(inputR));
-
     // Envelope follower with attack/release
     if (inputLevel > envL)
         envL += attackCoeff * (inputLevel - envL);
@@ -129,7 +306,7 @@ float Compressor::processSample(float inputL, float inputR, float& envL, float&
     envR = envL;
 
     // Convert to dB for gain calculation
-    float inputDb = DSPUtils::linearToDecibels(envL);
+    float inputDb = DSPUtils::fastLinearToDecibels(envL);
 
     // Calculate gain reduction
     float gainReductionDb = computeGain(inputDb);
@@ -138,54 +315,391 @@ float Compressor::processSample(float inputL, float inputR, float& envL, float&
     if (autoRelease && gainReductionDb > 6.0f)
     {
         // Increase release time for heavy compression
-        float autoReleaseCoeff = DSPUtils::calculateCoefficient(currentSampleRate, releaseMs * 2.0f);
         envL += (autoReleaseCoeff - releaseCoeff) * 0.5f * (inputLevel - envL);
     }
 
     return gainReductionDb;
 }
 
-void Compressor::process(juce::AudioBuffer<float>& buffer)
+float Compressor::applyGainCurve(float* levels, int numLevels) const
 {
-    if (bypassed)
-        return;
+    // Replaces levels in dB by the (negative) gain in dB
+    float maxGR = 0.0f;
 
-    const int numChannels = buffer.getNumChannels();
-    const int numSamples = buffer.getNumSamples();
+    if (activeCurve != nullptr)
+    {
+        for (int i = 0; i < numLevels; ++i)
+        {
+            float gainReductionDb = activeCurve->lookup(levels[i]);
+            maxGR = std::max(maxGR, gainReductionDb);
+            levels[i] = -gainReductionDb;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < numLevels; ++i)
+        {
+            float gainReductionDb = computeStaticGain(levels[i], threshold, ratio, kneeWidth);
+            maxGR = std::max(maxGR, gainReductionDb);
+            levels[i] = -gainReductionDb;
+        }
+    }
 
-    if (numChannels == 0)
-        return;
+    return maxGR;
+}
 
-    float* leftChannel = buffer.getWritePointer(0);
-    float* rightChannel = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
+void Compressor::rampControlGains(const float* targets, int numTargets, float* gains, int numSamples)
+{
+    // Each control point starts a ramp that reaches its target gain one
+    // control interval later. Samples are computed from the ramp's start and
+    // their position in the ramp, so the result doesn't depend on where the
+    // chunks split it.
+    const float stepScale = 1.0f / static_cast<float>(controlInterval);
+    int rampPosition = controlInterval - samplesUntilControlPoint;
+    int i = 0;
+
+    for (int k = 0; k <= numTargets; ++k)
+    {
+        const int segmentEnd = k < numTargets ? samplesUntilControlPoint + k * controlInterval : numSamples;
 
-    float maxGR = 0.0f;
+        for (; i < segmentEnd; ++i)
+            gains[i] = controlGain + controlGainStep * static_cast<float>(++rampPosition);
 
-    // Smoothing coefficient for gain changes (prevents clicks/pops)
-    // Use a fast smoothing time of ~1ms
-    float gainSmoothCoeff = DSPUtils::calculateCoefficient(currentSampleRate, 1.0f);
+        if (k < numTargets)
+        {
+            controlGain += controlGainStep * static_cast<float>(controlInterval);
+            controlGainStep = (targets[k] - controlGain) * stepScale;
+            rampPosition = 0;
+        }
+    }
+
+    samplesUntilControlPoint += numTargets * controlInterval - numSamples;
+}
+
+void Compressor::blendRMSLevels(const float* leftChannel, const float* rightChannel, float* levels, int numSamples)
+{
+    float* squares = scratchBuffer.getWritePointer(Squares);
+
+    // Mean square of the channels
+    juce::FloatVectorOperations::multiply(squares, leftChannel, leftChannel, numSamples);
+
+    if (rightChannel)
+    {
+        juce::FloatVectorOperations::addWithMultiply(squares, rightChannel, rightChannel, numSamples);
+        juce::FloatVectorOperations::multiply(squares, 0.5f, numSamples);
+    }
+
+    // Running sum over the window (serial), replaced by the exact sum of the
+    // window's squares each time the ring wraps
+    const double windowScale = 1.0 / static_cast<double>(rmsWindowSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float square = squares[i];
+        rmsSum += static_cast<double>(square) - static_cast<double>(rmsSquares[(size_t) rmsPosition]);
+        rmsFreshSum += static_cast<double>(square);
+        rmsSquares[(size_t) rmsPosition] = square;
+
+        if (++rmsPosition == rmsWindowSamples)
+        {
+            rmsPosition = 0;
+            rmsSum = rmsFreshSum;
+            rmsFreshSum = 0.0;
+        }
+
+        squares[i] = static_cast<float>(std::max(0.0, rmsSum) * windowScale);
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+        levels[i] += detectorBlend * (std::sqrt(squares[i]) - levels[i]);
+}
+
+void Compressor::pushPeakCandidate(juce::uint32 sampleIndex, float level)
+{
+    // Candidates that can never be the maximum again (an equal or louder
+    // level arrived after them) are dropped from the back
+    const int capacity = static_cast<int>(peakCandidates.size());
+
+    while (peakCount > 0 && peakCandidates[(size_t) ((peakFront + peakCount - 1) % capacity)].level <= level)
+        --peakCount;
+
+    peakCandidates[(size_t) ((peakFront + peakCount) % capacity)] = { sampleIndex, level };
+    ++peakCount;
+}
+
+void Compressor::rebuildPeakCandidates()
+{
+    // Refill the deque with the levels of the current window, oldest first
+    // (nothing to refill before prepare() has sized the history)
+    const int capacity = static_cast<int>(levelHistory.size());
+    peakFront = 0;
+    peakCount = 0;
+
+    for (int age = std::min(lookaheadSamples, capacity - 1); age > 0; --age)
+    {
+        int position = levelHistoryPosition - age;
+        if (position < 0)
+            position += capacity;
+
+        pushPeakCandidate(peakSampleIndex - static_cast<juce::uint32>(age), levelHistory[(size_t) position]);
+    }
+}
+
+void Compressor::applyLookahead(float* levels, int numSamples)
+{
+    // Sliding maximum over the last lookaheadSamples + 1 levels, expired
+    // candidates are dropped from the front. The levels also go into the
+    // history the deque is rebuilt from when the length changes.
+    const int capacity = static_cast<int>(peakCandidates.size());
+    const juce::uint32 window = static_cast<juce::uint32>(lookaheadSamples);
 
     for (int i = 0; i < numSamples; ++i)
     {
-        float inL = leftChannel[i];
-        float inR = rightChannel ? rightChannel[i] : inL;
+        const float level = levels[i];
+
+        levelHistory[(size_t) levelHistoryPosition] = level;
+        if (++levelHistoryPosition == capacity)
+            levelHistoryPosition = 0;
+
+        pushPeakCandidate(peakSampleIndex, level);
+
+        while (peakSampleIndex - peakCandidates[(size_t) peakFront].sampleIndex > window)
+        {
+            peakFront = (peakFront + 1) % capacity;
+            --peakCount;
+        }
+
+        levels[i] = peakCandidates[(size_t) peakFront].level;
+        ++peakSampleIndex;
+    }
+}
+
+void Compressor::delayAudio(float* leftChannel, float* rightChannel, int numSamples)
+{
+    const int bufferSize = lookaheadBuffer.getNumSamples();
+    const int numFadeSamples = std::min(numSamples, lookaheadFadeRemaining);
+    const float fadeStep = 1.0f / static_cast<float>(lookaheadFadeLength);
+    int position = lookaheadWritePosition;
+
+    // Reads the ring delay samples behind the write position, before the
+    // write (a delay of 0 is the input itself)
+    auto readDelayed = [bufferSize] (const float* ring, int writePosition, int delay, float input)
+    {
+        if (delay == 0)
+            return input;
+
+        const int readPosition = writePosition - delay;
+        return ring[readPosition < 0 ? readPosition + bufferSize : readPosition];
+    };
+
+    for (int channel = 0; channel < (rightChannel ? 2 : 1); ++channel)
+    {
+        float* samples = channel == 0 ? leftChannel : rightChannel;
+        float* ring = lookaheadBuffer.getWritePointer(channel);
+        position = lookaheadWritePosition;
 
-        float gainReductionDb = processSample(inL, inR, envelopeL, envelopeR);
-        maxGR = std::max(maxGR, gainReductionDb);
+        // After a length change, crossfade from the old read offset. Coming
+        // from no lookahead the ring starts from silence, so the audio is
+        // faded into it as well.
+        int i = 0;
+
+        for (; i < numFadeSamples; ++i)
+        {
+            const float previous = readDelayed(ring, position, previousLookaheadSamples, samples[i]);
+            const float current = readDelayed(ring, position, lookaheadSamples, samples[i]);
+            const float fade = static_cast<float>(lookaheadFadeRemaining - i - 1) * fadeStep;
+
+            ring[position] = previousLookaheadSamples == 0 ? samples[i] * (1.0f - fade) : samples[i];
+            samples[i] = current + fade * (previous - current);
+
+            if (++position == bufferSize)
+                position = 0;
+        }
+
+        // Without lookahead the rest passes straight through
+        if (lookaheadSamples == 0)
+            continue;
+
+        for (; i < numSamples; ++i)
+        {
+            int readPosition = position - lookaheadSamples;
+            if (readPosition < 0)
+                readPosition += bufferSize;
+
+            const float delayed = ring[readPosition];
+            ring[position] = samples[i];
+            samples[i] = delayed;
+
+            if (++position == bufferSize)
+                position = 0;
+        }
+    }
+
+    lookaheadWritePosition = position;
+    lookaheadFadeRemaining -= numFadeSamples;
+}
+
+float Compressor::processChunk(float* leftChannel, float* rightChannel, int numSamples)
+{
+    float* gains = scratchBuffer.getWritePointer(Gains);
+    float maxGR = 0.0f;
+
+    // Detector level (max of stereo channels for linked compression), taken
+    // before the audio goes into the lookahead delay
+    if (rightChannel)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            gains[i] = std::max(std::abs(leftChannel[i]), std::abs(rightChannel[i]));
+    }
+    else
+    {
+        juce::FloatVectorOperations::abs(gains, leftChannel, numSamples);
+    }
+
+    if (detectorBlend > 0.0f)
+        blendRMSLevels(leftChannel, rightChannel, gains, numSamples);
+
+    if (lookaheadSamples > 0)
+        applyLookahead(gains, numSamples);
+
+    if (lookaheadSamples > 0 || lookaheadFadeRemaining > 0)
+        delayAudio(leftChannel, rightChannel, numSamples);
+
+    // The auto-release needs the gain reduction of every sample
+    if (autoRelease)
+    {
+        // It feeds the gain reduction back into the envelope, so this path
+        // stays per-sample
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float gainReductionDb = processSample(gains[i], envelopeL, envelopeR);
+            maxGR = std::max(maxGR, gainReductionDb);
+            gains[i] = -gainReductionDb;
+        }
 
         // Convert gain reduction to linear
-        float targetGain = DSPUtils::decibelsToLinear(-gainReductionDb);
+        DSPUtils::fastDecibelsToLinear(gains, gains, numSamples);
+    }
+    else
+    {
+        // Envelope follower (serial)
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float inputLevel = gains[i];
+
+            if (inputLevel > envelopeL)
+                envelopeL += attackCoeff * (inputLevel - envelopeL);
+            else
+                envelopeL += releaseCoeff * (inputLevel - envelopeL);
+
+            gains[i] = envelopeL;
+        }
+
+        envelopeR = envelopeL;
+
+        if (controlInterval > 1)
+        {
+            // Gain computer only at this chunk's control points, linear ramps between
+            float* targets = scratchBuffer.getWritePointer(ControlPoints);
+            int numTargets = 0;
+
+            for (int i = samplesUntilControlPoint; i < numSamples; i += controlInterval)
+                targets[numTargets++] = gains[i];
+
+            DSPUtils::fastLinearToDecibels(targets, targets, numTargets);
+            maxGR = applyGainCurve(targets, numTargets);
+            DSPUtils::fastDecibelsToLinear(targets, targets, numTargets);
+
+            // The gain smoothing also runs at control rate, so the ramps
+            // carry the final gain
+            for (int k = 0; k < numTargets; ++k)
+            {
+                smoothedGain += gainSmoothCoeff * (targets[k] - smoothedGain);
+                targets[k] = smoothedGain * makeupLinear;
+            }
+
+            rampControlGains(targets, numTargets, gains, numSamples);
+
+            juce::FloatVectorOperations::multiply(leftChannel, gains, numSamples);
+            if (rightChannel)
+                juce::FloatVectorOperations::multiply(rightChannel, gains, numSamples);
+
+            return maxGR;
+        }
+        else
+        {
+            DSPUtils::fastLinearToDecibels(gains, gains, numSamples);
+            maxGR = applyGainCurve(gains, numSamples);
+            DSPUtils::fastDecibelsToLinear(gains, gains, numSamples);
+        }
+    }
+
+    // Smooth the gain to prevent clicks/pops, then apply with makeup gain
+    for (int i = 0; i < numSamples; ++i)
+    {
+        smoothedGain += gainSmoothCoeff * (gains[i] - smoothedGain);
+        gains[i] = smoothedGain * makeupLinear;
+    }
+
+    juce::FloatVectorOperations::multiply(leftChannel, gains, numSamples);
+    if (rightChannel)
+        juce::FloatVectorOperations::multiply(rightChannel, gains, numSamples);
 
-        // Smooth the gain to prevent clicks/pops
-        smoothedGain += gainSmoothCoeff * (targetGain - smoothedGain);
+    return maxGR;
+}
+
+void Compressor::process(juce::AudioBuffer<float>& buffer)
+{
+    const int numChannels = buffer.getNumChannels();
+
+    if (numChannels == 0 || ! beginBlock())
+        return;
+
+    processTile(buffer.getWritePointer(0), numChannels > 1 ? buffer.getWritePointer(1) : nullptr,
+                buffer.getNumSamples());
+    endBlock();
+}
+
+bool Compressor::beginBlock()
+{
+    // While bypassed only the lookahead delay runs
+    if (bypassed)
+        return lookaheadSamples > 0 || lookaheadFadeRemaining > 0;
+
+    // Pick up the latest gain curve table; fall back to the formula while the
+    // table for the current settings is still being built
+    gainCurves.acquire();
+    const GainCurve& curve = gainCurves.getReadBuffer();
+    activeCurve = curve.matches(threshold, ratio, kneeWidth) ? &curve : nullptr;
+
+    blockMaxGainReduction = 0.0f;
+    return true;
+}
+
+void Compressor::processTile(float* leftChannel, float* rightChannel, int numSamples)
+{
+    if (bypassed)
+    {
+        delayAudio(leftChannel, rightChannel, numSamples);
+        return;
+    }
 
-        // Apply compression with makeup gain
-        leftChannel[i] = inL * smoothedGain * makeupLinear;
-        if (rightChannel)
-            rightChannel[i] = inR * smoothedGain * makeupLinear;
+    const int chunkSize = scratchBuffer.getNumSamples();
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        const int n = std::min(chunkSize, numSamples - start);
+        blockMaxGainReduction = std::max(blockMaxGainReduction,
+                                         processChunk(leftChannel + start, rightChannel ? rightChannel + start : nullptr, n));
     }
+}
+
+void Compressor::endBlock()
+{
+    if (bypassed)
+        return;
 
     // Smooth the gain reduction for metering
-    smoothedGainReduction = smoothedGainReduction * 0.9f + maxGR * 0.1f;
+    smoothedGainReduction = smoothedGainReduction * 0.9f + blockMaxGainReduction * 0.1f;
     currentGainReduction = smoothedGainReduction;
 }
@@ -12,6 +12,14 @@ public:
     void process(juce::AudioBuffer<float>& buffer);
     void reset();
 
+    // Tile-wise processing for the processor's chain scheduler: beginBlock()
+    // once per host block (false when bypassed), processTile() over
+    // consecutive stretches of it, then endBlock() for the metering. Same
+    // result as process() on the whole block.
+    bool beginBlock();
+    void processTile(float* leftChannel, float* rightChannel, int numSamples);
+    void endBlock();
+
     // Parameters
     void setThreshold(float thresholdDb);      // -60 to 0 dB
     void setRatio(float ratio);                 // 1 to 20
@@ -20,15 +28,75 @@ public:
     void setMakeupGain(float gainDb);           // 0 to 24 dB
     void setKnee(float kneeDb);                 // Soft knee width in dB
     void setAutoRelease(bool enabled);
+    void setControlInterval(int numSamples);    // Gain computer every N samples (1 = audio rate);
+                                                // only used by the bench, the plugin runs at audio rate
+    void setLookahead(float lookaheadMs);       // 0 to 10 ms
+    void setDetectorBlend(float rmsAmount);     // 0 (peak) to 1 (RMS)
+    void setRMSWindow(float windowMs);          // 1 to 50 ms
     void setBypass(bool shouldBypass);
 
+    // Bakes the static curve for these settings into a lookup table and hands
+    // it to the audio thread. Not real-time safe: call from a background thread
+    // or prepare time. Does nothing if the settings match the last table built.
+    void updateGainCurve(float thresholdDb, float ratio, float kneeDb);
+
     float getGainReduction() const { return currentGainReduction; }
     bool isBypassed() const { return bypassed; }
 
+    // Lookahead delays the audio against the detector, so it is latency the
+    // host has to compensate. Also applied while bypassed, so the latency
+    // doesn't change when the compressor is switched in and out.
+    static constexpr float maxLookaheadMs = 10.0f;
+    static int getLookaheadSamples(float timeMs, double sampleRate);
+    int getLatencySamples() const { return lookaheadSamples; }
+
 private:
-    float processSample(float inputL, float inputR, float& envelopeL, float& envelopeR);
+    float processSample(float inputLevel, float& envelopeL, float& envelopeR);
+    void blendRMSLevels(const float* leftChannel, const float* rightChannel, float* levels, int numSamples);
+    void resetRMS();
+    void applyLookahead(float* levels, int numSamples);
+    void pushPeakCandidate(juce::uint32 sampleIndex, float level);
+    void rebuildPeakCandidates();
+    void delayAudio(float* leftChannel, float* rightChannel, int numSamples);
+    float processChunk(float* leftChannel, float* rightChannel, int numSamples);
+    float applyGainCurve(float* levels, int numLevels) const;
+    void rampControlGains(const float* targets, int numTargets, float* gains, int numSamples);
     void updateCoefficients();
-    float computeGain(float inputDb);
+    void updateGainSmoothing();
+    void restartControlRamps();
+    float computeGain(float inputDb) const;
+    static float computeStaticGain(float inputDb, float thresholdDb, float ratio, float kneeWidth);
+
+    // Static gain curve (gain reduction in dB) sampled over the input level in
+    // dB and read with linear interpolation. Levels above the table continue
+    // along the last segment, which is exact past the knee.
+    struct GainCurve
+    {
+        static constexpr float minDb = -72.0f;
+        static constexpr float maxDb = 48.0f;
+        static constexpr float pointsPerDb = 16.0f;
+        static constexpr int numPoints = static_cast<int>((maxDb - minDb) * pointsPerDb) + 1;
+
+        // Settings the table was built for (a negative knee marks an empty table)
+        float threshold = 0.0f;
+        float ratio = 1.0f;
+        float kneeWidth = -1.0f;
+
+        std::array<float, numPoints> gainReductionDb {};
+
+        bool matches(float thresholdDb, float newRatio, float kneeDb) const
+        {
+            return threshold == thresholdDb && ratio == newRatio && kneeWidth == kneeDb;
+        }
+
+        float lookup(float inputDb) const
+        {
+            const float position = std::max(0.0f, (inputDb - minDb) * pointsPerDb);
+            const int index = std::min(static_cast<int>(position), numPoints - 2);
+            const float fraction = position - static_cast<float>(index);
+            return gainReductionDb[(size_t) index] + fraction * (gainReductionDb[(size_t) index + 1] - gainReductionDb[(size_t) index]);
+        }
+    };
 
     // Parameters
     float threshold = -20.0f;    // dB
@@ -39,17 +107,91 @@ private:
     float kneeWidth = 6.0f;      // dB (soft knee)
     bool autoRelease = false;
     bool bypassed = false;
+    int controlInterval = 1;     // samples
+    float lookaheadMs = 0.0f;    // ms
+    float detectorBlend = 0.0f;  // 0 = peak, 1 = RMS
+    float rmsWindowMs = 10.0f;   // ms
 
     // Coefficients (calculated from parameters)
     float attackCoeff = 0.0f;
     float releaseCoeff = 0.0f;
+    float autoReleaseCoeff = 0.0f;  // release at twice the time, used under heavy reduction
     float makeupLinear = 1.0f;
+    float gainSmoothCoeff = 0.0f;   // ~1 ms gain smoothing, per control point at control rate
+
+    // Per-sample level/gain and the control-rate gain targets for the current
+    // chunk. Sized in prepare(); longer host blocks are processed in chunks
+    // of this size.
+    enum ScratchChannel { Gains = 0, ControlPoints, Squares, NumScratchChannels };
+    juce::AudioBuffer<float> scratchBuffer { NumScratchChannels, 512 };
 
     // State
     double currentSampleRate = 44100.0;
     float envelopeL = 0.0f;
     float envelopeR = 0.0f;
+
     float currentGainReduction = 0.0f;
     float smoothedGainReduction = 0.0f;
     float smoothedGain = 1.0f;  // Smoothed gain for click-free compression
+
+    // Current block (see beginBlock())
+    float blockMaxGainReduction = 0.0f;
+
+    // Control-rate gain computer: output gain ramp (including makeup) from the
+    // last control point and the offset of the next control point from the
+    // start of the next chunk
+    float controlGain = 1.0f;
+    float controlGainStep = 0.0f;
+    int samplesUntilControlPoint = 0;
+
+    // RMS detector: mean square of the channels over the last rmsWindowSamples,
+    // kept as a running sum over a ring of squares (sized in prepare() for
+    // maxRMSWindowMs). Rounding errors in the running sum are flushed once per
+    // window: by then the window holds exactly the squares summed into
+    // rmsFreshSum since the last flush, so that sum replaces it.
+    static constexpr float maxRMSWindowMs = 50.0f;
+    int rmsWindowSamples = 1;
+    std::vector<float> rmsSquares;
+    int rmsPosition = 0;
+    double rmsSum = 0.0;
+    double rmsFreshSum = 0.0;
+
+    // Lookahead: the audio runs through a delay line of lookaheadSamples while
+    // the detector sees the maximum level over the window from the delayed
+    // sample up to the newest one. The maximum is kept by a monotonic deque
+    // (sample counter and level, levels decreasing from the front), so each
+    // sample is pushed and popped at most once whatever the window length.
+    // The detector levels are also kept in a history ring, so the deque can be
+    // rebuilt when the length changes, and the delay line crossfades from the
+    // old length over lookaheadFadeMs. The rings are sized in prepare() for
+    // maxLookaheadMs.
+    struct PeakCandidate
+    {
+        juce::uint32 sampleIndex = 0;
+        float level = 0.0f;
+    };
+
+    static constexpr float lookaheadFadeMs = 5.0f;
+    int lookaheadSamples = 0;
+    juce::AudioBuffer<float> lookaheadBuffer { 2, 1 };
+    int lookaheadWritePosition = 0;
+    int previousLookaheadSamples = 0;
+    int lookaheadFadeLength = 1;
+    int lookaheadFadeRemaining = 0;
+
+    std::vector<PeakCandidate> peakCandidates;
+    int peakFront = 0;
+    int peakCount = 0;
+    juce::uint32 peakSampleIndex = 0;
+
+    std::vector<float> levelHistory;
+    int levelHistoryPosition = 0;
+
+    // Gain curve tables, built by updateGainCurve() and picked up per block.
+    // Until a table for the current settings arrives the curve is computed
+    // directly.
+    DSPUtils::TripleBuffer<GainCurve> gainCurves;
+    const GainCurve* activeCurve = nullptr;
+    juce::SpinLock gainCurveBuildLock;
+    float builtThreshold = 0.0f, builtRatio = 1.0f, builtKnee = -1.0f;
 };
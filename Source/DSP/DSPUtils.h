@@ -1,6 +1,19 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define VOXPROC_SIMD_SSE 1
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+ #include <arm_neon.h>
+ #define VOXPROC_SIMD_NEON 1
+#endif
 
 namespace DSPUtils
 {
@@ -14,6 +27,185 @@ namespace DSPUtils
         return std::pow(10.0f, dB / 20.0f);
     }
 
+    //==========================================================================
+    // Fast dB <-> linear conversions for the dynamics hot path
+    //
+    // log2 splits off the float exponent and fits the mantissa with a degree-5
+    // polynomial (abs error < 7e-5); exp2 rebuilds the exponent bits and fits
+    // the fraction with a degree-4 polynomial (rel error < 7e-6). Converted to
+    // dB both stay below 0.001 dB of 20*log10(x) and pow(10, dB/20).
+    //
+    // Levels below -100 dB (1e-5) are clamped to -100 dB, the same value
+    // linearToDecibels reports for silence. The batch versions run four
+    // values per SIMD register and give the same results as the scalar ones.
+    //==========================================================================
+    namespace FastMath
+    {
+        constexpr float log2C0 = 1.44262594f, log2C1 = -0.71739147f, log2C2 = 0.443910369f,
+                        log2C3 = -0.230329031f, log2C4 = 0.0612532559f;
+        constexpr float exp2C0 = 0.693133188f, exp2C1 = 0.240661615f,
+                        exp2C2 = 0.0534020724f, exp2C3 = 0.0127891302f;
+
+        constexpr float dBPerLog2 = 6.02059991f;      // 20 * log10(2)
+        constexpr float log2PerDB = 0.166096404f;     // 1 / dBPerLog2
+        constexpr float minLevel = 1.0e-5f;           // -100 dB
+        constexpr float maxExponent = 126.0f;
+    }
+
+    // log2(x) for normal x > 0
+    inline float fastLog2(float x)
+    {
+        using namespace FastMath;
+        std::int32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        const float exponent = static_cast<float>((bits >> 23) - 127);
+        bits = (bits & 0x007fffff) | 0x3f800000;
+
+        float mantissa;
+        std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+        const float t = mantissa - 1.0f;
+        return exponent + t * (log2C0 + t * (log2C1 + t * (log2C2 + t * (log2C3 + t * log2C4))));
+    }
+
+    inline float fastExp2(float x)
+    {
+        using namespace FastMath;
+        x = std::clamp(x, -maxExponent, maxExponent);
+
+        const float integer = std::floor(x);
+        const float f = x - integer;
+        const float fraction = 1.0f + f * (exp2C0 + f * (exp2C1 + f * (exp2C2 + f * exp2C3)));
+
+        const std::int32_t bits = (static_cast<std::int32_t>(integer) + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return fraction * scale;
+    }
+
+    inline float fastLinearToDecibels(float linear)
+    {
+        return FastMath::dBPerLog2 * fastLog2(std::max(linear, FastMath::minLevel));
+    }
+
+    inline float fastDecibelsToLinear(float dB)
+    {
+        return fastExp2(dB * FastMath::log2PerDB);
+    }
+
+    // Batch versions (in-place allowed)
+    inline void fastLinearToDecibels(const float* linear, float* dB, int numSamples)
+    {
+        int i = 0;
+
+       #if VOXPROC_SIMD_SSE
+        using namespace FastMath;
+        const __m128 minLevelV = _mm_set1_ps(minLevel);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128i mantissaMask = _mm_set1_epi32(0x007fffff);
+        const __m128i oneBits = _mm_set1_epi32(0x3f800000);
+        const __m128i bias = _mm_set1_epi32(127);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const __m128i bits = _mm_castps_si128(_mm_max_ps(_mm_loadu_ps(linear + i), minLevelV));
+            const __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), bias));
+            const __m128 t = _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, mantissaMask), oneBits)), one);
+
+            __m128 poly = _mm_add_ps(_mm_set1_ps(log2C3), _mm_mul_ps(t, _mm_set1_ps(log2C4)));
+            poly = _mm_add_ps(_mm_set1_ps(log2C2), _mm_mul_ps(t, poly));
+            poly = _mm_add_ps(_mm_set1_ps(log2C1), _mm_mul_ps(t, poly));
+            poly = _mm_add_ps(_mm_set1_ps(log2C0), _mm_mul_ps(t, poly));
+
+            const __m128 log2 = _mm_add_ps(exponent, _mm_mul_ps(t, poly));
+            _mm_storeu_ps(dB + i, _mm_mul_ps(_mm_set1_ps(dBPerLog2), log2));
+        }
+       #elif VOXPROC_SIMD_NEON
+        using namespace FastMath;
+        const float32x4_t minLevelV = vdupq_n_f32(minLevel);
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const uint32x4_t mantissaMask = vdupq_n_u32(0x007fffff);
+        const uint32x4_t oneBits = vdupq_n_u32(0x3f800000);
+        const int32x4_t bias = vdupq_n_s32(127);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const uint32x4_t bits = vreinterpretq_u32_f32(vmaxq_f32(vld1q_f32(linear + i), minLevelV));
+            const float32x4_t exponent = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), bias));
+            const float32x4_t t = vsubq_f32(vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, mantissaMask), oneBits)), one);
+
+            float32x4_t poly = vaddq_f32(vdupq_n_f32(log2C3), vmulq_f32(t, vdupq_n_f32(log2C4)));
+            poly = vaddq_f32(vdupq_n_f32(log2C2), vmulq_f32(t, poly));
+            poly = vaddq_f32(vdupq_n_f32(log2C1), vmulq_f32(t, poly));
+            poly = vaddq_f32(vdupq_n_f32(log2C0), vmulq_f32(t, poly));
+
+            const float32x4_t log2 = vaddq_f32(exponent, vmulq_f32(t, poly));
+            vst1q_f32(dB + i, vmulq_f32(vdupq_n_f32(dBPerLog2), log2));
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+            dB[i] = fastLinearToDecibels(linear[i]);
+    }
+
+    inline void fastDecibelsToLinear(const float* dB, float* linear, int numSamples)
+    {
+        int i = 0;
+
+       #if VOXPROC_SIMD_SSE
+        using namespace FastMath;
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 lo = _mm_set1_ps(-maxExponent), hi = _mm_set1_ps(maxExponent);
+        const __m128i bias = _mm_set1_epi32(127);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            __m128 x = _mm_mul_ps(_mm_loadu_ps(dB + i), _mm_set1_ps(log2PerDB));
+            x = _mm_min_ps(_mm_max_ps(x, lo), hi);
+
+            // floor() from truncation (SSE2 has no round-down instruction)
+            __m128 integer = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+            integer = _mm_sub_ps(integer, _mm_and_ps(_mm_cmpgt_ps(integer, x), one));
+            const __m128 f = _mm_sub_ps(x, integer);
+
+            __m128 poly = _mm_add_ps(_mm_set1_ps(exp2C2), _mm_mul_ps(f, _mm_set1_ps(exp2C3)));
+            poly = _mm_add_ps(_mm_set1_ps(exp2C1), _mm_mul_ps(f, poly));
+            poly = _mm_add_ps(_mm_set1_ps(exp2C0), _mm_mul_ps(f, poly));
+            const __m128 fraction = _mm_add_ps(one, _mm_mul_ps(f, poly));
+
+            const __m128i bits = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(integer), bias), 23);
+            _mm_storeu_ps(linear + i, _mm_mul_ps(fraction, _mm_castsi128_ps(bits)));
+        }
+       #elif VOXPROC_SIMD_NEON
+        using namespace FastMath;
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t lo = vdupq_n_f32(-maxExponent), hi = vdupq_n_f32(maxExponent);
+        const int32x4_t bias = vdupq_n_s32(127);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            float32x4_t x = vmulq_f32(vld1q_f32(dB + i), vdupq_n_f32(log2PerDB));
+            x = vminq_f32(vmaxq_f32(x, lo), hi);
+
+            float32x4_t integer = vcvtq_f32_s32(vcvtq_s32_f32(x));
+            integer = vsubq_f32(integer, vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(integer, x), vreinterpretq_u32_f32(one))));
+            const float32x4_t f = vsubq_f32(x, integer);
+
+            float32x4_t poly = vaddq_f32(vdupq_n_f32(exp2C2), vmulq_f32(f, vdupq_n_f32(exp2C3)));
+            poly = vaddq_f32(vdupq_n_f32(exp2C1), vmulq_f32(f, poly));
+            poly = vaddq_f32(vdupq_n_f32(exp2C0), vmulq_f32(f, poly));
+            const float32x4_t fraction = vaddq_f32(one, vmulq_f32(f, poly));
+
+            const int32x4_t bits = vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(integer), bias), 23);
+            vst1q_f32(linear + i, vmulq_f32(fraction, vreinterpretq_f32_s32(bits)));
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+            linear[i] = fastDecibelsToLinear(dB[i]);
+    }
+
     inline float mapRange(float value, float inMin, float inMax, float outMin, float outMax)
     {
         return outMin + (outMax - outMin) * (value - inMin) / (inMax - inMin);
@@ -94,6 +286,25 @@ namespace DSPUtils
         return c;
     }
 
+    // Second-order allpass: flat magnitude, with the phase of a low-pass and
+    // high-pass pair. At Q 0.707 it's the sum of a Linkwitz-Riley 4 crossover.
+    inline BiquadCoeffs calcAllPass(double sampleRate, float freq, float q = 0.707f)
+    {
+        BiquadCoeffs c;
+        float w0 = 2.0f * juce::MathConstants<float>::pi * freq / static_cast<float>(sampleRate);
+        float cosw0 = std::cos(w0);
+        float sinw0 = std::sin(w0);
+        float alpha = sinw0 / (2.0f * q);
+
+        float a0 = 1.0f + alpha;
+        c.b0 = (1.0f - alpha) / a0;
+        c.b1 = (-2.0f * cosw0) / a0;
+        c.b2 = 1.0f;
+        c.a1 = (-2.0f * cosw0) / a0;
+        c.a2 = (1.0f - alpha) / a0;
+        return c;
+    }
+
     inline BiquadCoeffs calcPeaking(double sampleRate, float freq, float gainDb, float q = 1.0f)
     {
         BiquadCoeffs c;
@@ -149,4 +360,552 @@ namespace DSPUtils
         c.a2 = ((A + 1.0f) - (A - 1.0f) * cosw0 - sqrtA2alpha) / a0;
         return c;
     }
+
+    //==========================================================================
+    // Vectorized biquad kernel
+    //==========================================================================
+
+    // Direct Form I state for up to four independent lanes, stored
+    // structure-of-arrays so each history term loads as one SIMD register.
+    // Lane 0 is the left (or mono) channel, lane 1 the right channel.
+    struct alignas(16) BiquadLaneState
+    {
+        float x1[4] {}, x2[4] {};
+        float y1[4] {}, y2[4] {};
+    };
+
+    // Coefficients per lane, for running different filters side by side in
+    // one BiquadLaneState (e.g. two filters on a stereo pair)
+    struct alignas(16) BiquadLaneCoeffs
+    {
+        float b0[4] {}, b1[4] {}, b2[4] {};
+        float a1[4] {}, a2[4] {};
+
+        void setLane(int lane, const BiquadCoeffs& c)
+        {
+            b0[lane] = c.b0; b1[lane] = c.b1; b2[lane] = c.b2;
+            a1[lane] = c.a1; a2[lane] = c.a2;
+        }
+    };
+
+    // Runs one biquad in place over a block. With a right channel both
+    // channels run together in SIMD lanes, so the stereo pair costs about the
+    // same as one channel. The arithmetic order matches the scalar Direct Form I
+    // expression, so each lane gives the same result as a per-channel loop.
+    inline void processBiquad(float* left, float* right, int numSamples,
+                              const BiquadCoeffs& c, BiquadLaneState& state)
+    {
+        if (right == nullptr)
+        {
+            float x1 = state.x1[0], x2 = state.x2[0];
+            float y1 = state.y1[0], y2 = state.y2[0];
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float input = left[i];
+                const float output = c.b0 * input + c.b1 * x1 + c.b2 * x2 - c.a1 * y1 - c.a2 * y2;
+                x2 = x1;
+                x1 = input;
+                y2 = y1;
+                y1 = output;
+                left[i] = output;
+            }
+
+            state.x1[0] = x1; state.x2[0] = x2;
+            state.y1[0] = y1; state.y2[0] = y2;
+            return;
+        }
+
+       #if VOXPROC_SIMD_SSE
+        const __m128 b0 = _mm_set1_ps(c.b0), b1 = _mm_set1_ps(c.b1), b2 = _mm_set1_ps(c.b2);
+        const __m128 a1 = _mm_set1_ps(c.a1), a2 = _mm_set1_ps(c.a2);
+        __m128 x1 = _mm_load_ps(state.x1), x2 = _mm_load_ps(state.x2);
+        __m128 y1 = _mm_load_ps(state.y1), y2 = _mm_load_ps(state.y2);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const __m128 input = _mm_unpacklo_ps(_mm_load_ss(left + i), _mm_load_ss(right + i));
+
+            __m128 output = _mm_add_ps(_mm_mul_ps(b0, input), _mm_mul_ps(b1, x1));
+            output = _mm_add_ps(output, _mm_mul_ps(b2, x2));
+            output = _mm_sub_ps(output, _mm_mul_ps(a1, y1));
+            output = _mm_sub_ps(output, _mm_mul_ps(a2, y2));
+
+            x2 = x1;
+            x1 = input;
+            y2 = y1;
+            y1 = output;
+
+            _mm_store_ss(left + i, output);
+            _mm_store_ss(right + i, _mm_shuffle_ps(output, output, _MM_SHUFFLE(1, 1, 1, 1)));
+        }
+
+        _mm_store_ps(state.x1, x1); _mm_store_ps(state.x2, x2);
+        _mm_store_ps(state.y1, y1); _mm_store_ps(state.y2, y2);
+       #elif VOXPROC_SIMD_NEON
+        const float32x4_t b0 = vdupq_n_f32(c.b0), b1 = vdupq_n_f32(c.b1), b2 = vdupq_n_f32(c.b2);
+        const float32x4_t a1 = vdupq_n_f32(c.a1), a2 = vdupq_n_f32(c.a2);
+        float32x4_t x1 = vld1q_f32(state.x1), x2 = vld1q_f32(state.x2);
+        float32x4_t y1 = vld1q_f32(state.y1), y2 = vld1q_f32(state.y2);
+        float32x4_t input = vdupq_n_f32(0.0f);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            input = vsetq_lane_f32(left[i], input, 0);
+            input = vsetq_lane_f32(right[i], input, 1);
+
+            float32x4_t output = vaddq_f32(vmulq_f32(b0, input), vmulq_f32(b1, x1));
+            output = vaddq_f32(output, vmulq_f32(b2, x2));
+            output = vsubq_f32(output, vmulq_f32(a1, y1));
+            output = vsubq_f32(output, vmulq_f32(a2, y2));
+
+            x2 = x1;
+            x1 = input;
+            y2 = y1;
+            y1 = output;
+
+            left[i] = vgetq_lane_f32(output, 0);
+            right[i] = vgetq_lane_f32(output, 1);
+        }
+
+        vst1q_f32(state.x1, x1); vst1q_f32(state.x2, x2);
+        vst1q_f32(state.y1, y1); vst1q_f32(state.y2, y2);
+       #else
+        float* channels[2] = { left, right };
+        for (int lane = 0; lane < 2; ++lane)
+        {
+            float* data = channels[lane];
+            float x1 = state.x1[lane], x2 = state.x2[lane];
+            float y1 = state.y1[lane], y2 = state.y2[lane];
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float input = data[i];
+                const float output = c.b0 * input + c.b1 * x1 + c.b2 * x2 - c.a1 * y1 - c.a2 * y2;
+                x2 = x1;
+                x1 = input;
+                y2 = y1;
+                y1 = output;
+                data[i] = output;
+            }
+
+            state.x1[lane] = x1; state.x2[lane] = x2;
+            state.y1[lane] = y1; state.y2[lane] = y2;
+        }
+       #endif
+    }
+
+    // Out-of-place variant: copies the input into the output buffers first
+    inline void processBiquad(const float* inLeft, const float* inRight, float* outLeft, float* outRight,
+                              int numSamples, const BiquadCoeffs& c, BiquadLaneState& state)
+    {
+        std::copy(inLeft, inLeft + numSamples, outLeft);
+        if (inRight != nullptr)
+            std::copy(inRight, inRight + numSamples, outRight);
+
+        processBiquad(outLeft, inRight != nullptr ? outRight : nullptr, numSamples, c, state);
+    }
+
+    // Multiplies magnitudes[i] by the biquad's |H(e^jw)| at each point of a
+    // frequency grid, given cos/sin of w and 2w per point. Used to draw
+    // response curves: one pass per filter over all points, four at a time.
+    inline void multiplyByBiquadMagnitude(const BiquadCoeffs& c, const float* cosw, const float* sinw,
+                                          const float* cos2w, const float* sin2w, float* magnitudes, int numPoints)
+    {
+        int i = 0;
+
+       #if VOXPROC_SIMD_SSE
+        const __m128 b0 = _mm_set1_ps(c.b0), b1 = _mm_set1_ps(c.b1), b2 = _mm_set1_ps(c.b2);
+        const __m128 a1 = _mm_set1_ps(c.a1), a2 = _mm_set1_ps(c.a2), one = _mm_set1_ps(1.0f);
+
+        for (; i + 4 <= numPoints; i += 4)
+        {
+            const __m128 cw = _mm_loadu_ps(cosw + i), sw = _mm_loadu_ps(sinw + i);
+            const __m128 c2w = _mm_loadu_ps(cos2w + i), s2w = _mm_loadu_ps(sin2w + i);
+
+            const __m128 numReal = _mm_add_ps(b0, _mm_add_ps(_mm_mul_ps(b1, cw), _mm_mul_ps(b2, c2w)));
+            const __m128 numImag = _mm_add_ps(_mm_mul_ps(b1, sw), _mm_mul_ps(b2, s2w));
+            const __m128 denReal = _mm_add_ps(one, _mm_add_ps(_mm_mul_ps(a1, cw), _mm_mul_ps(a2, c2w)));
+            const __m128 denImag = _mm_add_ps(_mm_mul_ps(a1, sw), _mm_mul_ps(a2, s2w));
+
+            const __m128 numSq = _mm_add_ps(_mm_mul_ps(numReal, numReal), _mm_mul_ps(numImag, numImag));
+            const __m128 denSq = _mm_add_ps(_mm_mul_ps(denReal, denReal), _mm_mul_ps(denImag, denImag));
+
+            _mm_storeu_ps(magnitudes + i, _mm_mul_ps(_mm_loadu_ps(magnitudes + i), _mm_sqrt_ps(_mm_div_ps(numSq, denSq))));
+        }
+       #elif VOXPROC_SIMD_NEON && defined (__aarch64__)
+        const float32x4_t b0 = vdupq_n_f32(c.b0), b1 = vdupq_n_f32(c.b1), b2 = vdupq_n_f32(c.b2);
+        const float32x4_t a1 = vdupq_n_f32(c.a1), a2 = vdupq_n_f32(c.a2), one = vdupq_n_f32(1.0f);
+
+        for (; i + 4 <= numPoints; i += 4)
+        {
+            const float32x4_t cw = vld1q_f32(cosw + i), sw = vld1q_f32(sinw + i);
+            const float32x4_t c2w = vld1q_f32(cos2w + i), s2w = vld1q_f32(sin2w + i);
+
+            const float32x4_t numReal = vaddq_f32(b0, vaddq_f32(vmulq_f32(b1, cw), vmulq_f32(b2, c2w)));
+            const float32x4_t numImag = vaddq_f32(vmulq_f32(b1, sw), vmulq_f32(b2, s2w));
+            const float32x4_t denReal = vaddq_f32(one, vaddq_f32(vmulq_f32(a1, cw), vmulq_f32(a2, c2w)));
+            const float32x4_t denImag = vaddq_f32(vmulq_f32(a1, sw), vmulq_f32(a2, s2w));
+
+            const float32x4_t numSq = vaddq_f32(vmulq_f32(numReal, numReal), vmulq_f32(numImag, numImag));
+            const float32x4_t denSq = vaddq_f32(vmulq_f32(denReal, denReal), vmulq_f32(denImag, denImag));
+
+            vst1q_f32(magnitudes + i, vmulq_f32(vld1q_f32(magnitudes + i), vsqrtq_f32(vdivq_f32(numSq, denSq))));
+        }
+       #endif
+
+        // The imaginary parts' sign doesn't matter once squared
+        for (; i < numPoints; ++i)
+        {
+            const float numReal = c.b0 + (c.b1 * cosw[i] + c.b2 * cos2w[i]);
+            const float numImag = c.b1 * sinw[i] + c.b2 * sin2w[i];
+            const float denReal = 1.0f + (c.a1 * cosw[i] + c.a2 * cos2w[i]);
+            const float denImag = c.a1 * sinw[i] + c.a2 * sin2w[i];
+
+            const float numSq = numReal * numReal + numImag * numImag;
+            const float denSq = denReal * denReal + denImag * denImag;
+            magnitudes[i] *= std::sqrt(numSq / denSq);
+        }
+    }
+
+    //==========================================================================
+    // Per-sample linear gain ramp
+    //
+    // setTarget() starts a ramp of the given length from the current gain;
+    // apply() multiplies it into every channel of a block, so the result does
+    // not depend on how the host splits its blocks. Once the target is reached
+    // apply() is a plain multiply, and does nothing at all at unity gain.
+    //==========================================================================
+    class GainRamp
+    {
+    public:
+        void reset(float gain)
+        {
+            current = target = gain;
+            step = 0.0f;
+            remaining = 0;
+        }
+
+        void setTarget(float newTarget, int rampLengthSamples)
+        {
+            if (newTarget == target)
+                return;
+
+            target = newTarget;
+            remaining = std::max(1, rampLengthSamples);
+            step = (target - current) / static_cast<float>(remaining);
+        }
+
+        bool isRamping() const { return remaining > 0; }
+        float getCurrentGain() const { return current; }
+        float getTargetGain() const { return target; }
+
+        void apply(float* const* channels, int numChannels, int numSamples)
+        {
+            const int numRamped = std::min(numSamples, remaining);
+
+            if (numRamped > 0)
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    applyRamp(channels[ch], numRamped);
+
+                remaining -= numRamped;
+                current = remaining > 0 ? current + step * static_cast<float>(numRamped) : target;
+            }
+
+            if (current != 1.0f && numRamped < numSamples)
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    applyConstant(channels[ch] + numRamped, numSamples - numRamped);
+            }
+        }
+
+        // Levels of one block, per channel, measured after the gain
+        static constexpr int maxChannels = 8;
+
+        struct Levels
+        {
+            std::array<float, maxChannels> peak {};
+            std::array<float, maxChannels> rms {};
+        };
+
+        // Fused apply(): in the same pass over the block, measures each
+        // channel's peak and RMS after the gain and writes the channel
+        // average to the mix. The mix is given as two parts so it can go
+        // straight into a ring buffer; samples beyond mixSize1 + mixSize2 are
+        // measured but not mixed. The gain values match apply() exactly.
+        void applyAndMeasure(float* const* channels, int numChannels, int numSamples,
+                             float* mix1, int mixSize1, float* mix2, int mixSize2, Levels& levels)
+        {
+            jassert(numChannels <= maxChannels);
+            numChannels = std::min(numChannels, maxChannels);
+
+            std::array<float, maxChannels> sumSquares {};
+            levels.peak.fill(0.0f);
+            levels.rms.fill(0.0f);
+
+            const int numRamped = std::min(numSamples, remaining);
+            const int mixEnd1 = std::min(numSamples, mixSize1);
+            const int mixEnd2 = std::min(numSamples, mixSize1 + mixSize2);
+            const float mixScale = numChannels > 1 ? 1.0f / static_cast<float>(numChannels) : 1.0f;
+            const float settledGain = numRamped > 0 ? target : current;  // After the ramp, as in apply()
+
+            // Split the block where the ramp ends or the mix changes part
+            for (int position = 0; position < numSamples;)
+            {
+                int end = numSamples;
+                for (int boundary : { numRamped, mixEnd1, mixEnd2 })
+                    if (boundary > position)
+                        end = std::min(end, boundary);
+
+                const bool ramping = position < numRamped;
+                float* mix = position < mixEnd1 ? mix1 + position
+                           : position < mixEnd2 ? mix2 + (position - mixEnd1)
+                           : nullptr;
+
+                const float gain = ramping ? current : settledGain;
+
+                fusedSegment(channels, numChannels, position, end - position,
+                             gain, ramping ? step : 0.0f, ramping ? position : 0,
+                             ! ramping && gain == 1.0f, mix, mixScale, levels.peak.data(), sumSquares.data());
+
+                position = end;
+            }
+
+            if (numRamped > 0)
+            {
+                remaining -= numRamped;
+                current = remaining > 0 ? current + step * static_cast<float>(numRamped) : target;
+            }
+
+            if (numSamples > 0)
+                for (int ch = 0; ch < numChannels; ++ch)
+                    levels.rms[(size_t) ch] = std::sqrt(sumSquares[(size_t) ch] / static_cast<float>(numSamples));
+        }
+
+    private:
+        // One stretch of applyAndMeasure(). Sample i gets
+        // gain + gainStep * (indexOffset + i + 1), like applyRamp().
+        static void fusedSegment(float* const* channels, int numChannels, int offset, int numSamples,
+                                 float gain, float gainStep, int indexOffset, bool unityGain,
+                                 float* mix, float mixScale, float* peaks, float* sumSquares)
+        {
+            int i = 0;
+
+           #if VOXPROC_SIMD_SSE
+            const __m128 gainV = _mm_set1_ps(gain), stepV = _mm_set1_ps(gainStep);
+            const __m128 offsets = _mm_setr_ps(1.0f, 2.0f, 3.0f, 4.0f);
+            const __m128 scaleV = _mm_set1_ps(mixScale);
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+            __m128 peakV[maxChannels], squaresV[maxChannels];
+            for (int ch = 0; ch < numChannels; ++ch)
+                peakV[ch] = squaresV[ch] = _mm_setzero_ps();
+
+            for (; i + 4 <= numSamples; i += 4)
+            {
+                const __m128 index = _mm_add_ps(_mm_set1_ps(static_cast<float>(indexOffset + i)), offsets);
+                const __m128 g = _mm_add_ps(gainV, _mm_mul_ps(stepV, index));
+                __m128 sum = _mm_setzero_ps();
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    float* data = channels[ch] + offset + i;
+                    __m128 x = _mm_loadu_ps(data);
+
+                    if (! unityGain)
+                    {
+                        x = _mm_mul_ps(x, g);
+                        _mm_storeu_ps(data, x);
+                    }
+
+                    peakV[ch] = _mm_max_ps(peakV[ch], _mm_and_ps(x, absMask));
+                    squaresV[ch] = _mm_add_ps(squaresV[ch], _mm_mul_ps(x, x));
+                    sum = _mm_add_ps(sum, x);
+                }
+
+                if (mix != nullptr)
+                    _mm_storeu_ps(mix + i, _mm_mul_ps(sum, scaleV));
+            }
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                alignas(16) float peakLanes[4], squareLanes[4];
+                _mm_store_ps(peakLanes, peakV[ch]);
+                _mm_store_ps(squareLanes, squaresV[ch]);
+
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    peaks[ch] = std::max(peaks[ch], peakLanes[lane]);
+                    sumSquares[ch] += squareLanes[lane];
+                }
+            }
+           #elif VOXPROC_SIMD_NEON
+            const float32x4_t gainV = vdupq_n_f32(gain), stepV = vdupq_n_f32(gainStep);
+            const float offsetValues[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+            const float32x4_t offsets = vld1q_f32(offsetValues);
+            const float32x4_t scaleV = vdupq_n_f32(mixScale);
+
+            float32x4_t peakV[maxChannels], squaresV[maxChannels];
+            for (int ch = 0; ch < numChannels; ++ch)
+                peakV[ch] = squaresV[ch] = vdupq_n_f32(0.0f);
+
+            for (; i + 4 <= numSamples; i += 4)
+            {
+                const float32x4_t index = vaddq_f32(vdupq_n_f32(static_cast<float>(indexOffset + i)), offsets);
+                const float32x4_t g = vaddq_f32(gainV, vmulq_f32(stepV, index));
+                float32x4_t sum = vdupq_n_f32(0.0f);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    float* data = channels[ch] + offset + i;
+                    float32x4_t x = vld1q_f32(data);
+
+                    if (! unityGain)
+                    {
+                        x = vmulq_f32(x, g);
+                        vst1q_f32(data, x);
+                    }
+
+                    peakV[ch] = vmaxq_f32(peakV[ch], vabsq_f32(x));
+                    squaresV[ch] = vaddq_f32(squaresV[ch], vmulq_f32(x, x));
+                    sum = vaddq_f32(sum, x);
+                }
+
+                if (mix != nullptr)
+                    vst1q_f32(mix + i, vmulq_f32(sum, scaleV));
+            }
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                float peakLanes[4], squareLanes[4];
+                vst1q_f32(peakLanes, peakV[ch]);
+                vst1q_f32(squareLanes, squaresV[ch]);
+
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    peaks[ch] = std::max(peaks[ch], peakLanes[lane]);
+                    sumSquares[ch] += squareLanes[lane];
+                }
+            }
+           #endif
+
+            for (; i < numSamples; ++i)
+            {
+                const float g = gain + gainStep * static_cast<float>(indexOffset + i + 1);
+                float sum = 0.0f;
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    float& sample = channels[ch][offset + i];
+
+                    if (! unityGain)
+                        sample *= g;
+
+                    peaks[ch] = std::max(peaks[ch], std::abs(sample));
+                    sumSquares[ch] += sample * sample;
+                    sum += sample;
+                }
+
+                if (mix != nullptr)
+                    mix[i] = sum * mixScale;
+            }
+        }
+
+        // Sample i gets current + step * (i + 1); the SIMD and scalar paths
+        // compute the same values
+        void applyRamp(float* data, int numSamples) const
+        {
+            int i = 0;
+
+           #if VOXPROC_SIMD_SSE
+            const __m128 startV = _mm_set1_ps(current), stepV = _mm_set1_ps(step);
+            const __m128 offsets = _mm_setr_ps(1.0f, 2.0f, 3.0f, 4.0f);
+
+            for (; i + 4 <= numSamples; i += 4)
+            {
+                const __m128 index = _mm_add_ps(_mm_set1_ps(static_cast<float>(i)), offsets);
+                const __m128 gain = _mm_add_ps(startV, _mm_mul_ps(stepV, index));
+                _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), gain));
+            }
+           #elif VOXPROC_SIMD_NEON
+            const float32x4_t startV = vdupq_n_f32(current), stepV = vdupq_n_f32(step);
+            const float offsetValues[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+            const float32x4_t offsets = vld1q_f32(offsetValues);
+
+            for (; i + 4 <= numSamples; i += 4)
+            {
+                const float32x4_t index = vaddq_f32(vdupq_n_f32(static_cast<float>(i)), offsets);
+                const float32x4_t gain = vaddq_f32(startV, vmulq_f32(stepV, index));
+                vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), gain));
+            }
+           #endif
+
+            for (; i < numSamples; ++i)
+                data[i] *= current + step * static_cast<float>(i + 1);
+        }
+
+        void applyConstant(float* data, int numSamples) const
+        {
+            int i = 0;
+
+           #if VOXPROC_SIMD_SSE
+            const __m128 gain = _mm_set1_ps(current);
+            for (; i + 4 <= numSamples; i += 4)
+                _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), gain));
+           #elif VOXPROC_SIMD_NEON
+            const float32x4_t gain = vdupq_n_f32(current);
+            for (; i + 4 <= numSamples; i += 4)
+                vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), gain));
+           #endif
+
+            for (; i < numSamples; ++i)
+                data[i] *= current;
+        }
+
+        float current = 1.0f;
+        float target = 1.0f;
+        float step = 0.0f;
+        int remaining = 0;
+    };
+
+    //==========================================================================
+    // Lock-free triple buffer for handing data designed on a background thread
+    // to the audio thread. One writer and one reader; neither ever blocks, and
+    // the reader always sees the most recently published complete value.
+    //==========================================================================
+    template <typename T>
+    class TripleBuffer
+    {
+    public:
+        // Writer side: fill getWriteBuffer(), then publish()
+        T& getWriteBuffer() { return buffers[(size_t) writeIndex]; }
+
+        void publish()
+        {
+            writeIndex = middle.exchange(writeIndex | dirtyFlag, std::memory_order_acq_rel) & indexMask;
+        }
+
+        // Reader side: picks up the latest published value, if any. Returns
+        // true when getReadBuffer() changed.
+        bool acquire()
+        {
+            if ((middle.load(std::memory_order_relaxed) & dirtyFlag) == 0)
+                return false;
+
+            readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+            return true;
+        }
+
+        const T& getReadBuffer() const { return buffers[(size_t) readIndex]; }
+
+    private:
+        static constexpr int indexMask = 3;
+        static constexpr int dirtyFlag = 4;
+
+        std::array<T, 3> buffers {};
+        int writeIndex = 0;
+        int readIndex = 1;
+        std::atomic<int> middle { 2 };
+    };
 }
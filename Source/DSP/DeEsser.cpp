@@ -1,5 +1,34 @@
 #include "DeEsser.h"
 
+#if ! (VOXPROC_SIMD_SSE || VOXPROC_SIMD_NEON)
+namespace
+{
+    // One lane of a BiquadLaneState run on its own, for the scalar fallback.
+    // Same arithmetic as DSPUtils::processBiquad.
+    void processBiquadLane(const float* input, float* output, int numSamples,
+                           const DSPUtils::BiquadLaneCoeffs& c, DSPUtils::BiquadLaneState& state, int lane)
+    {
+        const float b0 = c.b0[lane], b1 = c.b1[lane], b2 = c.b2[lane], a1 = c.a1[lane], a2 = c.a2[lane];
+        float x1 = state.x1[lane], x2 = state.x2[lane];
+        float y1 = state.y1[lane], y2 = state.y2[lane];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float in = input[i];
+            const float out = b0 * in + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+            x2 = x1;
+            x1 = in;
+            y2 = y1;
+            y1 = out;
+            output[i] = out;
+        }
+
+        state.x1[lane] = x1; state.x2[lane] = x2;
+        state.y1[lane] = y1; state.y2[lane] = y2;
+    }
+}
+#endif
+
 DeEsser::DeEsser()
 {
 }
@@ -8,23 +37,33 @@ void DeEsser::prepare(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
     currentBlockSize = samplesPerBlock;
+    scratchBuffer.setSize(NumScratchChannels, juce::jmax(1, samplesPerBlock), false, true);
 
     // Fast attack, medium release for sibilance detection
     attackCoeff = DSPUtils::calculateCoefficient(sampleRate, 0.5f);   // 0.5ms attack
     releaseCoeff = DSPUtils::calculateCoefficient(sampleRate, 50.0f); // 50ms release
 
-    updateFilters();
+    // Smoothing coefficient for gain changes (prevents clicks)
+    gainSmoothCoeff = DSPUtils::calculateCoefficient(sampleRate, 2.0f);
+
+    // Enough input history to prime the high band at the lowest frequency,
+    // which takes the longest to settle
+    historySize = juce::nextPowerOfTwo(getPrimeLength(DSPUtils::calcHighPass(sampleRate, minFrequency * 0.8f, 0.707f)));
+    inputHistory.setSize(2, historySize);
+
+    designCoefficients(frequency, currentSampleRate, localCoefficients);
+    activeCoefficients = &localCoefficients;
     reset();
 }
 
 void DeEsser::reset()
 {
-    detectionStateL = {};
-    detectionStateR = {};
-    hpStateL = {};
-    hpStateR = {};
-    lpStateL = {};
-    lpStateR = {};
+    bandState = {};
+    outputState = {};
+    inputHistory.clear();
+    historyWritePos = 0;
+    splitFiltersPrimed = false;
+    allpassPrimed = true;
     envelopeL = 0.0f;
     envelopeR = 0.0f;
     currentGainReduction = 0.0f;
@@ -32,34 +71,96 @@ void DeEsser::reset()
     smoothedGain = 1.0f;
 }
 
-void DeEsser::updateFilters()
+void DeEsser::designCoefficients(float frequencyHz, double sampleRate, CoefficientSet& set)
 {
+    set.frequency = frequencyHz;
+    set.sampleRate = sampleRate;
+
     // Detection bandpass filter centered on sibilance frequency
     // Use relatively narrow Q for precise detection
-    detectionCoeffs = DSPUtils::calcBandPass(currentSampleRate, frequency, 2.0f);
+    set.detection = DSPUtils::calcBandPass(sampleRate, frequencyHz, 2.0f);
+
+    // For split-band mode: Linkwitz-Riley 4 crossover below the detection
+    // frequency (the high band is highPass twice, the sum is allPass)
+    set.highPass = DSPUtils::calcHighPass(sampleRate, frequencyHz * 0.8f, 0.707f);
+    set.allPass = DSPUtils::calcAllPass(sampleRate, frequencyHz * 0.8f, 0.707f);
+
+    for (int lane = 0; lane < 2; ++lane)
+    {
+        set.bandStage.setLane(lane, set.detection);
+        set.bandStage.setLane(lane + 2, set.highPass);
+        set.outputStage.setLane(lane, set.highPass);
+        set.outputStage.setLane(lane + 2, set.allPass);
+    }
+
+    set.primeLength = getPrimeLength(set.highPass);
+}
+
+int DeEsser::getPrimeLength(const DSPUtils::BiquadCoeffs& highPass)
+{
+    // The high band's double poles have radius sqrt(a2); its impulse response
+    // decays as n * r^n. Replaying this many input samples lets it fall below
+    // -120 dB, so priming from history reproduces the state of a continuously
+    // run filter. The allpass has the same poles.
+    const float poleRadius = std::min(std::sqrt(std::max(highPass.a2, 1.0e-6f)), 0.9999f);
+    const float singlePoleSamples = std::log(1.0e-6f) / std::log(poleRadius);
+    const float samplesToSettle = std::log(1.0e-6f / std::max(singlePoleSamples, 1.0f)) / std::log(poleRadius);
+    return std::max(static_cast<int>(std::ceil(samplesToSettle)), 16);
+}
+
+void DeEsser::updateCoefficients(float frequencyHz, double sampleRate)
+{
+    // Same range as the setter
+    frequencyHz = std::clamp(frequencyHz, minFrequency, 12000.0f);
 
-    // For split-band mode: high-pass and low-pass at the crossover frequency
-    highPassCoeffs = DSPUtils::calcHighPass(currentSampleRate, frequency * 0.8f, 0.707f);
-    lowPassCoeffs = DSPUtils::calcLowPass(currentSampleRate, frequency * 0.8f, 0.707f);
+    const juce::SpinLock::ScopedLockType lock(designLock);
+
+    if (frequencyHz == designedFrequency && sampleRate == designedSampleRate)
+        return;
+
+    designCoefficients(frequencyHz, sampleRate, coefficientSets.getWriteBuffer());
+    coefficientSets.publish();
+
+    designedFrequency = frequencyHz;
+    designedSampleRate = sampleRate;
 }
 
-float DeEsser::processBiquad(float input, const DSPUtils::BiquadCoeffs& coeffs, BiquadState& state)
+void DeEsser::selectCoefficients()
 {
-    float output = coeffs.b0 * input + coeffs.b1 * state.x1 + coeffs.b2 * state.x2
-                 - coeffs.a1 * state.y1 - coeffs.a2 * state.y2;
+    coefficientSets.acquire();
+    const CoefficientSet& published = coefficientSets.getReadBuffer();
 
-    state.x2 = state.x1;
-    state.x1 = input;
-    state.y2 = state.y1;
-    state.y1 = output;
+    auto isCurrent = [this](const CoefficientSet& set)
+    {
+        return set.sampleRate == currentSampleRate && set.frequency == frequency;
+    };
 
-    return output;
+    if (isCurrent(localCoefficients))
+    {
+        activeCoefficients = &localCoefficients;
+    }
+    else if (published.sampleRate == currentSampleRate && (! designOnAudioThread || isCurrent(published)))
+    {
+        // Without audio-thread design, a stale published set keeps running
+        // until the background thread catches up
+        activeCoefficients = &published;
+    }
+    else if (designOnAudioThread)
+    {
+        designCoefficients(frequency, currentSampleRate, localCoefficients);
+        activeCoefficients = &localCoefficients;
+    }
+    else
+    {
+        // Nothing published for this sample rate yet: keep running the set
+        // prepare() designed for it
+        activeCoefficients = &localCoefficients;
+    }
 }
 
 void DeEsser::setFrequency(float freq)
 {
-    frequency = std::clamp(freq, 2000.0f, 12000.0f);
-    updateFilters();
+    frequency = std::clamp(freq, minFrequency, 12000.0f);
 }
 
 void DeEsser::setThreshold(float thresholdDb)
@@ -89,94 +190,559 @@ void DeEsser::setBypass(bool shouldBypass)
 
 void DeEsser::process(juce::AudioBuffer<float>& buffer)
 {
-    if (bypassed)
-        return;
-
     const int numChannels = buffer.getNumChannels();
-    const int numSamples = buffer.getNumSamples();
 
-    if (numChannels == 0)
+    if (numChannels == 0 || ! beginBlock())
         return;
 
-    float* leftChannel = buffer.getWritePointer(0);
-    float* rightChannel = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
+    processTile(buffer.getWritePointer(0), numChannels > 1 ? buffer.getWritePointer(1) : nullptr,
+                buffer.getNumSamples());
+    endBlock();
+}
 
-    float maxGR = 0.0f;
-    float thresholdLinear = DSPUtils::decibelsToLinear(threshold);
+bool DeEsser::beginBlock()
+{
+    selectCoefficients();
 
-    // Smoothing coefficient for gain changes (prevents clicks)
-    float gainSmoothCoeff = DSPUtils::calculateCoefficient(currentSampleRate, 2.0f);
+    if (bypassed)
+        return false;
+
+    blockMaxGainReduction = 0.0f;
+    return true;
+}
+
+void DeEsser::processTile(float* leftChannel, float* rightChannel, int numSamples)
+{
+    const int chunkSize = scratchBuffer.getNumSamples();
+    const ChunkKernel kernel = chunkKernels[mode == SplitBand ? 0 : 1][listenMode ? 1 : 0][rightChannel ? 1 : 0];
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        const int numThisTime = std::min(chunkSize, numSamples - start);
+        float chunkGR = (this->*kernel)(leftChannel + start, rightChannel ? rightChannel + start : nullptr, numThisTime);
+        blockMaxGainReduction = std::max(blockMaxGainReduction, chunkGR);
+    }
+}
+
+void DeEsser::endBlock()
+{
+    // Smooth the gain reduction for metering
+    smoothedGainReduction = smoothedGainReduction * 0.85f + blockMaxGainReduction * 0.15f;
+    currentGainReduction = smoothedGainReduction;
+}
+
+const DeEsser::ChunkKernel DeEsser::chunkKernels[2][2][2] =
+{
+    { { &DeEsser::processChunk<SplitBand, false, 1>, &DeEsser::processChunk<SplitBand, false, 2> },
+      { &DeEsser::processChunk<SplitBand, true, 1>,  &DeEsser::processChunk<SplitBand, true, 2> } },
+    { { &DeEsser::processChunk<Wideband, false, 1>,  &DeEsser::processChunk<Wideband, false, 2> },
+      { &DeEsser::processChunk<Wideband, true, 1>,   &DeEsser::processChunk<Wideband, true, 2> } }
+};
+
+void DeEsser::pushInputHistory(const float* leftChannel, const float* rightChannel, int numSamples)
+{
+    // Only the most recent historySize samples matter
+    if (numSamples > historySize)
+    {
+        leftChannel += numSamples - historySize;
+        if (rightChannel)
+            rightChannel += numSamples - historySize;
+        numSamples = historySize;
+    }
+
+    const int firstPart = std::min(numSamples, historySize - historyWritePos);
+    inputHistory.copyFrom(0, historyWritePos, leftChannel, firstPart);
+    inputHistory.copyFrom(0, 0, leftChannel + firstPart, numSamples - firstPart);
+
+    if (rightChannel)
+    {
+        inputHistory.copyFrom(1, historyWritePos, rightChannel, firstPart);
+        inputHistory.copyFrom(1, 0, rightChannel + firstPart, numSamples - firstPart);
+    }
+
+    historyWritePos = (historyWritePos + numSamples) & (historySize - 1);
+}
+
+void DeEsser::primeSplitFilters(bool stereo)
+{
+    // Rebuild the high band's filter state by replaying the input that came
+    // just before the current chunk through freshly reset filters, then move
+    // it into the high-pass lanes of the two stages
+    DSPUtils::BiquadLaneState firstState, secondState;
+
+    replayInputHistory(stereo, [&](const float* inL, const float* inR, int numSamples)
+    {
+        float* highL = scratchBuffer.getWritePointer(HighL);
+        float* highR = stereo ? scratchBuffer.getWritePointer(HighR) : nullptr;
+
+        DSPUtils::processBiquad(inL, inR, highL, highR, numSamples, activeCoefficients->highPass, firstState);
+        DSPUtils::processBiquad(highL, highR, numSamples, activeCoefficients->highPass, secondState);
+    });
+
+    for (int lane = 0; lane < 2; ++lane)
+    {
+        bandState.x1[lane + 2] = firstState.x1[lane];
+        bandState.x2[lane + 2] = firstState.x2[lane];
+        bandState.y1[lane + 2] = firstState.y1[lane];
+        bandState.y2[lane + 2] = firstState.y2[lane];
+
+        outputState.x1[lane] = secondState.x1[lane];
+        outputState.x2[lane] = secondState.x2[lane];
+        outputState.y1[lane] = secondState.y1[lane];
+        outputState.y2[lane] = secondState.y2[lane];
+    }
+
+    splitFiltersPrimed = true;
+}
+
+void DeEsser::primeAllpass(bool stereo)
+{
+    // The same for the allpass after running without it
+    DSPUtils::BiquadLaneState state;
+
+    replayInputHistory(stereo, [&](const float* inL, const float* inR, int numSamples)
+    {
+        float* allpassL = scratchBuffer.getWritePointer(AllpassL);
+        float* allpassR = stereo ? scratchBuffer.getWritePointer(AllpassR) : nullptr;
+
+        DSPUtils::processBiquad(inL, inR, allpassL, allpassR, numSamples, activeCoefficients->allPass, state);
+    });
+
+    for (int lane = 0; lane < 2; ++lane)
+    {
+        outputState.x1[lane + 2] = state.x1[lane];
+        outputState.x2[lane + 2] = state.x2[lane];
+        outputState.y1[lane + 2] = state.y1[lane];
+        outputState.y2[lane + 2] = state.y2[lane];
+    }
+
+    allpassPrimed = true;
+}
+
+template <typename Callback>
+void DeEsser::replayInputHistory(bool stereo, Callback&& process)
+{
+    // The last primeLength input samples in scratch-sized pieces
+    const int scratchSize = scratchBuffer.getNumSamples();
+    const int primeLength = std::min(activeCoefficients->primeLength, historySize);
+    int readPos = (historyWritePos - primeLength) & (historySize - 1);
+    int remaining = primeLength;
+
+    while (remaining > 0)
+    {
+        const int numThisTime = std::min({ remaining, historySize - readPos, scratchSize });
+        process(inputHistory.getReadPointer(0, readPos),
+                stereo ? inputHistory.getReadPointer(1, readPos) : nullptr, numThisTime);
+
+        readPos = (readPos + numThisTime) & (historySize - 1);
+        remaining -= numThisTime;
+    }
+}
+
+void DeEsser::runDetection(const float* leftChannel, const float* rightChannel, int numSamples)
+{
+    // The band stage's detection lanes and the output stage's allpass lanes
+    // as one 4-lane filter. Mono runs the left channel in both lanes of a pair.
+    const auto& band = activeCoefficients->bandStage;
+    const auto& output = activeCoefficients->outputStage;
+    const float* inR = rightChannel != nullptr ? rightChannel : leftChannel;
+
+    float* detectedL = scratchBuffer.getWritePointer(DetectedL);
+    float* detectedR = scratchBuffer.getWritePointer(DetectedR);
+    float* allpassL = scratchBuffer.getWritePointer(AllpassL);
+    float* allpassR = scratchBuffer.getWritePointer(AllpassR);
+
+   #if VOXPROC_SIMD_SSE
+    // Lanes 0-1 from the band stage, 2-3 from the output stage
+    auto join = [](const float* low, const float* high)
+    {
+        return _mm_shuffle_ps(_mm_load_ps(low), _mm_load_ps(high), _MM_SHUFFLE(3, 2, 1, 0));
+    };
+
+    auto split = [](__m128 v, float* low, float* high)
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(low), v);
+        _mm_storeh_pi(reinterpret_cast<__m64*>(high + 2), v);
+    };
+
+    const __m128 b0 = join(band.b0, output.b0), b1 = join(band.b1, output.b1), b2 = join(band.b2, output.b2);
+    const __m128 a1 = join(band.a1, output.a1), a2 = join(band.a2, output.a2);
+    __m128 x1 = join(bandState.x1, outputState.x1), x2 = join(bandState.x2, outputState.x2);
+    __m128 y1 = join(bandState.y1, outputState.y1), y2 = join(bandState.y2, outputState.y2);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        __m128 input = _mm_unpacklo_ps(_mm_load_ss(leftChannel + i), _mm_load_ss(inR + i));
+        input = _mm_movelh_ps(input, input);
+
+        __m128 out = _mm_add_ps(_mm_mul_ps(b0, input), _mm_mul_ps(b1, x1));
+        out = _mm_add_ps(out, _mm_mul_ps(b2, x2));
+        out = _mm_sub_ps(out, _mm_mul_ps(a1, y1));
+        out = _mm_sub_ps(out, _mm_mul_ps(a2, y2));
+
+        x2 = x1;
+        x1 = input;
+        y2 = y1;
+        y1 = out;
+
+        const __m128 high = _mm_movehl_ps(out, out);
+        _mm_store_ss(detectedL + i, out);
+        _mm_store_ss(detectedR + i, _mm_shuffle_ps(out, out, _MM_SHUFFLE(1, 1, 1, 1)));
+        _mm_store_ss(allpassL + i, high);
+        _mm_store_ss(allpassR + i, _mm_shuffle_ps(high, high, _MM_SHUFFLE(1, 1, 1, 1)));
+    }
+
+    split(x1, bandState.x1, outputState.x1); split(x2, bandState.x2, outputState.x2);
+    split(y1, bandState.y1, outputState.y1); split(y2, bandState.y2, outputState.y2);
+   #elif VOXPROC_SIMD_NEON
+    auto join = [](const float* low, const float* high)
+    {
+        return vcombine_f32(vld1_f32(low), vld1_f32(high + 2));
+    };
+
+    auto split = [](float32x4_t v, float* low, float* high)
+    {
+        vst1_f32(low, vget_low_f32(v));
+        vst1_f32(high + 2, vget_high_f32(v));
+    };
+
+    const float32x4_t b0 = join(band.b0, output.b0), b1 = join(band.b1, output.b1), b2 = join(band.b2, output.b2);
+    const float32x4_t a1 = join(band.a1, output.a1), a2 = join(band.a2, output.a2);
+    float32x4_t x1 = join(bandState.x1, outputState.x1), x2 = join(bandState.x2, outputState.x2);
+    float32x4_t y1 = join(bandState.y1, outputState.y1), y2 = join(bandState.y2, outputState.y2);
 
     for (int i = 0; i < numSamples; ++i)
     {
-        float inL = leftChannel[i];
-        float inR = rightChannel ? rightChannel[i] : inL;
+        const float32x2_t pair = vset_lane_f32(inR[i], vdup_n_f32(leftChannel[i]), 1);
+        const float32x4_t input = vcombine_f32(pair, pair);
+
+        float32x4_t out = vaddq_f32(vmulq_f32(b0, input), vmulq_f32(b1, x1));
+        out = vaddq_f32(out, vmulq_f32(b2, x2));
+        out = vsubq_f32(out, vmulq_f32(a1, y1));
+        out = vsubq_f32(out, vmulq_f32(a2, y2));
+
+        x2 = x1;
+        x1 = input;
+        y2 = y1;
+        y1 = out;
+
+        detectedL[i] = vgetq_lane_f32(out, 0);
+        detectedR[i] = vgetq_lane_f32(out, 1);
+        allpassL[i] = vgetq_lane_f32(out, 2);
+        allpassR[i] = vgetq_lane_f32(out, 3);
+    }
 
-        // Run detection filter on input
-        float detectedL = processBiquad(inL, detectionCoeffs, detectionStateL);
-        float detectedR = processBiquad(inR, detectionCoeffs, detectionStateR);
+    split(x1, bandState.x1, outputState.x1); split(x2, bandState.x2, outputState.x2);
+    split(y1, bandState.y1, outputState.y1); split(y2, bandState.y2, outputState.y2);
+   #else
+    processBiquadLane(leftChannel, detectedL, numSamples, band, bandState, 0);
+    processBiquadLane(inR, detectedR, numSamples, band, bandState, 1);
+    processBiquadLane(leftChannel, allpassL, numSamples, output, outputState, 2);
+    processBiquadLane(inR, allpassR, numSamples, output, outputState, 3);
+   #endif
+}
+
+void DeEsser::runCrossover(const float* leftChannel, const float* rightChannel, int numSamples)
+{
+    // Both stages in one pass; the output stage takes the band stage's
+    // high-pass lanes and the input
+    const auto& band = activeCoefficients->bandStage;
+    const auto& output = activeCoefficients->outputStage;
+    const float* inR = rightChannel != nullptr ? rightChannel : leftChannel;
+
+    float* detectedL = scratchBuffer.getWritePointer(DetectedL);
+    float* detectedR = scratchBuffer.getWritePointer(DetectedR);
+    float* allpassL = scratchBuffer.getWritePointer(AllpassL);
+    float* allpassR = scratchBuffer.getWritePointer(AllpassR);
+    float* highL = scratchBuffer.getWritePointer(HighL);
+    float* highR = scratchBuffer.getWritePointer(HighR);
+
+   #if VOXPROC_SIMD_SSE
+    const __m128 bb0 = _mm_load_ps(band.b0), bb1 = _mm_load_ps(band.b1), bb2 = _mm_load_ps(band.b2);
+    const __m128 ba1 = _mm_load_ps(band.a1), ba2 = _mm_load_ps(band.a2);
+    const __m128 ob0 = _mm_load_ps(output.b0), ob1 = _mm_load_ps(output.b1), ob2 = _mm_load_ps(output.b2);
+    const __m128 oa1 = _mm_load_ps(output.a1), oa2 = _mm_load_ps(output.a2);
+    __m128 bx1 = _mm_load_ps(bandState.x1), bx2 = _mm_load_ps(bandState.x2);
+    __m128 by1 = _mm_load_ps(bandState.y1), by2 = _mm_load_ps(bandState.y2);
+    __m128 ox1 = _mm_load_ps(outputState.x1), ox2 = _mm_load_ps(outputState.x2);
+    __m128 oy1 = _mm_load_ps(outputState.y1), oy2 = _mm_load_ps(outputState.y2);
 
-        // Envelope follower for detection
-        float detectedLevel = std::max(std::abs(detectedL), std::abs(detectedR));
+    for (int i = 0; i < numSamples; ++i)
+    {
+        __m128 input = _mm_unpacklo_ps(_mm_load_ss(leftChannel + i), _mm_load_ss(inR + i));
+        input = _mm_movelh_ps(input, input);
+
+        __m128 bandOut = _mm_add_ps(_mm_mul_ps(bb0, input), _mm_mul_ps(bb1, bx1));
+        bandOut = _mm_add_ps(bandOut, _mm_mul_ps(bb2, bx2));
+        bandOut = _mm_sub_ps(bandOut, _mm_mul_ps(ba1, by1));
+        bandOut = _mm_sub_ps(bandOut, _mm_mul_ps(ba2, by2));
+
+        bx2 = bx1;
+        bx1 = input;
+        by2 = by1;
+        by1 = bandOut;
+
+        // First high-pass (lanes 2-3) into lanes 0-1, the input into 2-3
+        const __m128 outputIn = _mm_shuffle_ps(bandOut, input, _MM_SHUFFLE(1, 0, 3, 2));
+
+        __m128 out = _mm_add_ps(_mm_mul_ps(ob0, outputIn), _mm_mul_ps(ob1, ox1));
+        out = _mm_add_ps(out, _mm_mul_ps(ob2, ox2));
+        out = _mm_sub_ps(out, _mm_mul_ps(oa1, oy1));
+        out = _mm_sub_ps(out, _mm_mul_ps(oa2, oy2));
+
+        ox2 = ox1;
+        ox1 = outputIn;
+        oy2 = oy1;
+        oy1 = out;
+
+        const __m128 allpass = _mm_movehl_ps(out, out);
+        _mm_store_ss(detectedL + i, bandOut);
+        _mm_store_ss(detectedR + i, _mm_shuffle_ps(bandOut, bandOut, _MM_SHUFFLE(1, 1, 1, 1)));
+        _mm_store_ss(highL + i, out);
+        _mm_store_ss(highR + i, _mm_shuffle_ps(out, out, _MM_SHUFFLE(1, 1, 1, 1)));
+        _mm_store_ss(allpassL + i, allpass);
+        _mm_store_ss(allpassR + i, _mm_shuffle_ps(allpass, allpass, _MM_SHUFFLE(1, 1, 1, 1)));
+    }
+
+    _mm_store_ps(bandState.x1, bx1); _mm_store_ps(bandState.x2, bx2);
+    _mm_store_ps(bandState.y1, by1); _mm_store_ps(bandState.y2, by2);
+    _mm_store_ps(outputState.x1, ox1); _mm_store_ps(outputState.x2, ox2);
+    _mm_store_ps(outputState.y1, oy1); _mm_store_ps(outputState.y2, oy2);
+   #elif VOXPROC_SIMD_NEON
+    const float32x4_t bb0 = vld1q_f32(band.b0), bb1 = vld1q_f32(band.b1), bb2 = vld1q_f32(band.b2);
+    const float32x4_t ba1 = vld1q_f32(band.a1), ba2 = vld1q_f32(band.a2);
+    const float32x4_t ob0 = vld1q_f32(output.b0), ob1 = vld1q_f32(output.b1), ob2 = vld1q_f32(output.b2);
+    const float32x4_t oa1 = vld1q_f32(output.a1), oa2 = vld1q_f32(output.a2);
+    float32x4_t bx1 = vld1q_f32(bandState.x1), bx2 = vld1q_f32(bandState.x2);
+    float32x4_t by1 = vld1q_f32(bandState.y1), by2 = vld1q_f32(bandState.y2);
+    float32x4_t ox1 = vld1q_f32(outputState.x1), ox2 = vld1q_f32(outputState.x2);
+    float32x4_t oy1 = vld1q_f32(outputState.y1), oy2 = vld1q_f32(outputState.y2);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float32x2_t pair = vset_lane_f32(inR[i], vdup_n_f32(leftChannel[i]), 1);
+        const float32x4_t input = vcombine_f32(pair, pair);
+
+        float32x4_t bandOut = vaddq_f32(vmulq_f32(bb0, input), vmulq_f32(bb1, bx1));
+        bandOut = vaddq_f32(bandOut, vmulq_f32(bb2, bx2));
+        bandOut = vsubq_f32(bandOut, vmulq_f32(ba1, by1));
+        bandOut = vsubq_f32(bandOut, vmulq_f32(ba2, by2));
+
+        bx2 = bx1;
+        bx1 = input;
+        by2 = by1;
+        by1 = bandOut;
+
+        const float32x4_t outputIn = vcombine_f32(vget_high_f32(bandOut), pair);
+
+        float32x4_t out = vaddq_f32(vmulq_f32(ob0, outputIn), vmulq_f32(ob1, ox1));
+        out = vaddq_f32(out, vmulq_f32(ob2, ox2));
+        out = vsubq_f32(out, vmulq_f32(oa1, oy1));
+        out = vsubq_f32(out, vmulq_f32(oa2, oy2));
+
+        ox2 = ox1;
+        ox1 = outputIn;
+        oy2 = oy1;
+        oy1 = out;
+
+        detectedL[i] = vgetq_lane_f32(bandOut, 0);
+        detectedR[i] = vgetq_lane_f32(bandOut, 1);
+        highL[i] = vgetq_lane_f32(out, 0);
+        highR[i] = vgetq_lane_f32(out, 1);
+        allpassL[i] = vgetq_lane_f32(out, 2);
+        allpassR[i] = vgetq_lane_f32(out, 3);
+    }
+
+    vst1q_f32(bandState.x1, bx1); vst1q_f32(bandState.x2, bx2);
+    vst1q_f32(bandState.y1, by1); vst1q_f32(bandState.y2, by2);
+    vst1q_f32(outputState.x1, ox1); vst1q_f32(outputState.x2, ox2);
+    vst1q_f32(outputState.y1, oy1); vst1q_f32(outputState.y2, oy2);
+   #else
+    processBiquadLane(leftChannel, detectedL, numSamples, band, bandState, 0);
+    processBiquadLane(inR, detectedR, numSamples, band, bandState, 1);
+    processBiquadLane(leftChannel, highL, numSamples, band, bandState, 2);
+    processBiquadLane(inR, highR, numSamples, band, bandState, 3);
+    processBiquadLane(highL, highL, numSamples, output, outputState, 0);
+    processBiquadLane(highR, highR, numSamples, output, outputState, 1);
+    processBiquadLane(leftChannel, allpassL, numSamples, output, outputState, 2);
+    processBiquadLane(inR, allpassR, numSamples, output, outputState, 3);
+   #endif
+}
+
+float DeEsser::computeGains(const float* detectedL, const float* detectedR, int numSamples, bool& gainIsUnity)
+{
+    float* gains = scratchBuffer.getWritePointer(Gain);
+
+    // Detection level (vectorizable)
+    if (detectedR)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            gains[i] = std::max(std::abs(detectedL[i]), std::abs(detectedR[i]));
+    }
+    else
+    {
+        for (int i = 0; i < numSamples; ++i)
+            gains[i] = std::abs(detectedL[i]);
+    }
+
+    // Envelope follower for detection (serial)
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float detectedLevel = gains[i];
 
         if (detectedLevel > envelopeL)
             envelopeL += attackCoeff * (detectedLevel - envelopeL);
         else
             envelopeL += releaseCoeff * (detectedLevel - envelopeL);
 
-        envelopeR = envelopeL; // Linked stereo
+        gains[i] = envelopeL;
+    }
 
-        // Calculate gain reduction
-        float gainReductionDb = 0.0f;
-        if (envelopeL > thresholdLinear)
-        {
-            float overDb = DSPUtils::linearToDecibels(envelopeL) - threshold;
-            gainReductionDb = std::min(overDb, range);
-        }
+    envelopeR = envelopeL; // Linked stereo
+
+    // Gain reduction: batch dB conversion, then the negated reduction is
+    // converted back to a linear target gain in place. The reduction is zero
+    // at the threshold, so comparing in dB matches the linear comparison.
+    float maxGR = 0.0f;
+
+    DSPUtils::fastLinearToDecibels(gains, gains, numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float gainReductionDb = juce::jlimit(0.0f, range, gains[i] - threshold);
         maxGR = std::max(maxGR, gainReductionDb);
+        gains[i] = -gainReductionDb;
+    }
+
+    DSPUtils::fastDecibelsToLinear(gains, gains, numSamples);
+
+    gainIsUnity = true;
 
-        // Smooth the gain to prevent clicks
-        float targetGain = DSPUtils::decibelsToLinear(-gainReductionDb);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Smooth the gain to prevent clicks. Snap once within -120 dB of the
+        // target so the gain actually settles on unity after de-essing.
+        float targetGain = gains[i];
         smoothedGain += gainSmoothCoeff * (targetGain - smoothedGain);
+        if (std::abs(targetGain - smoothedGain) < 1.0e-6f)
+            smoothedGain = targetGain;
+
+        gains[i] = smoothedGain;
+        gainIsUnity = gainIsUnity && smoothedGain == 1.0f;
+    }
+
+    return maxGR;
+}
 
-        if (listenMode)
+template <int ModeValue, bool Listen, int NumChannels>
+float DeEsser::processChunk(float* leftChannel, float* rightChannel, int numSamples)
+{
+    constexpr bool stereo = NumChannels == 2;
+    constexpr bool splitBand = ! Listen && ModeValue == SplitBand;
+
+    if (! stereo)
+        rightChannel = nullptr;
+
+    // Split-band runs detection and the allpass in one pass, with the high
+    // band joining it while it's needed. The other modes only need the
+    // detection filter; the allpass is primed from the input history when
+    // split-band takes over again.
+    if constexpr (splitBand)
+    {
+        if (! allpassPrimed)
+            primeAllpass(stereo);
+    }
+
+    const DSPUtils::BiquadLaneState bandStart = bandState;
+    const DSPUtils::BiquadLaneState outputStart = outputState;
+
+    if constexpr (splitBand)
+    {
+        if (splitFiltersPrimed)
+            runCrossover(leftChannel, rightChannel, numSamples);
+        else
+            runDetection(leftChannel, rightChannel, numSamples);
+    }
+    else
+    {
+        DSPUtils::processBiquad(leftChannel, rightChannel,
+                                scratchBuffer.getWritePointer(DetectedL), scratchBuffer.getWritePointer(DetectedR),
+                                numSamples, activeCoefficients->detection, bandState);
+    }
+
+    const float* detectedL = scratchBuffer.getReadPointer(DetectedL);
+    const float* detectedR = stereo ? scratchBuffer.getReadPointer(DetectedR) : nullptr;
+
+    bool gainIsUnity = true;
+    const float maxGR = computeGains(detectedL, detectedR, numSamples, gainIsUnity);
+    const float* gains = scratchBuffer.getReadPointer(Gain);
+
+    if constexpr (splitBand)
+    {
+        if (! gainIsUnity && ! splitFiltersPrimed)
         {
-            // Output only the detected sibilance band
-            leftChannel[i] = detectedL;
-            if (rightChannel)
-                rightChannel[i] = detectedR;
+            // Reduction starts in this chunk: run it again with the high
+            // band, its filters primed from the input history. Detection
+            // gives the same result the second time.
+            bandState = bandStart;
+            outputState = outputStart;
+            primeSplitFilters(stereo);
+            runCrossover(leftChannel, rightChannel, numSamples);
         }
-        else if (mode == SplitBand)
+
+        // The high band's state stays valid only while it keeps running
+        splitFiltersPrimed = ! gainIsUnity;
+    }
+    else
+    {
+        splitFiltersPrimed = false;
+        allpassPrimed = false;
+    }
+
+    pushInputHistory(leftChannel, rightChannel, numSamples);
+
+    if constexpr (Listen)
+    {
+        // Output only the detected sibilance band
+        juce::FloatVectorOperations::copy(leftChannel, detectedL, numSamples);
+        if constexpr (stereo)
+            juce::FloatVectorOperations::copy(rightChannel, detectedR, numSamples);
+    }
+    else if constexpr (splitBand)
+    {
+        // Low band + gain * high band, i.e. the crossover sum minus the part
+        // of the high band being taken out. At unity gain just the sum.
+        const float* allpassL = scratchBuffer.getReadPointer(AllpassL);
+        const float* allpassR = scratchBuffer.getReadPointer(AllpassR);
+
+        if (gainIsUnity)
         {
-            // Split-band mode: only reduce gain in the high frequency band
-            // But crossfade with dry signal to avoid phase artifacts when not de-essing
-            float lowL = processBiquad(inL, lowPassCoeffs, lpStateL);
-            float highL = processBiquad(inL, highPassCoeffs, hpStateL);
-            float processedL = lowL + highL * smoothedGain;
-
-            // Crossfade: when gain is 1.0 (no reduction), use dry signal
-            // When gain < 1.0, blend toward processed signal
-            float wetAmount = 1.0f - smoothedGain;  // 0 when no reduction, approaches 1 with more reduction
-            leftChannel[i] = inL * (1.0f - wetAmount) + processedL * wetAmount;
-
-            if (rightChannel)
-            {
-                float lowR = processBiquad(inR, lowPassCoeffs, lpStateR);
-                float highR = processBiquad(inR, highPassCoeffs, hpStateR);
-                float processedR = lowR + highR * smoothedGain;
-                rightChannel[i] = inR * (1.0f - wetAmount) + processedR * wetAmount;
-            }
+            juce::FloatVectorOperations::copy(leftChannel, allpassL, numSamples);
+            if constexpr (stereo)
+                juce::FloatVectorOperations::copy(rightChannel, allpassR, numSamples);
+
+            return maxGR;
         }
-        else
+
+        const float* highL = scratchBuffer.getReadPointer(HighL);
+        const float* highR = scratchBuffer.getReadPointer(HighR);
+
+        for (int i = 0; i < numSamples; ++i)
+            leftChannel[i] = allpassL[i] - (1.0f - gains[i]) * highL[i];
+
+        if constexpr (stereo)
         {
-            // Wideband mode: reduce gain of entire signal (no coloration when not active)
-            leftChannel[i] = inL * smoothedGain;
-            if (rightChannel)
-                rightChannel[i] = inR * smoothedGain;
+            for (int i = 0; i < numSamples; ++i)
+                rightChannel[i] = allpassR[i] - (1.0f - gains[i]) * highR[i];
         }
     }
+    else
+    {
+        // Wideband mode: reduce gain of entire signal (no coloration when not active)
+        juce::FloatVectorOperations::multiply(leftChannel, gains, numSamples);
+        if constexpr (stereo)
+            juce::FloatVectorOperations::multiply(rightChannel, gains, numSamples);
+    }
 
-    // Smooth the gain reduction for metering
-    smoothedGainReduction = smoothedGainReduction * 0.85f + maxGR * 0.15f;
-    currentGainReduction = smoothedGainReduction;
+    return maxGR;
 }
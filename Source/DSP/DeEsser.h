@@ -18,6 +18,13 @@ public:
     void process(juce::AudioBuffer<float>& buffer);
     void reset();
 
+    // Tile-wise processing for the processor's chain scheduler: beginBlock()
+    // once per host block (false when bypassed), processTile() over
+    // consecutive stretches of it, then endBlock() for the metering.
+    bool beginBlock();
+    void processTile(float* leftChannel, float* rightChannel, int numSamples);
+    void endBlock();
+
     // Parameters
     void setFrequency(float freq);           // 2kHz to 12kHz - center frequency for detection
     void setThreshold(float thresholdDb);    // -60 to 0 dB
@@ -26,12 +33,21 @@ public:
     void setListenMode(bool enabled);        // Solo the sibilance band
     void setBypass(bool shouldBypass);
 
+    // Designs the filters for this frequency and hands them to the audio
+    // thread. Not real-time safe: call from a background thread. Does nothing
+    // if the frequency matches the last set designed.
+    void updateCoefficients(float frequencyHz, double sampleRate);
+
+    // With this off, process() never designs filters itself once prepared: a
+    // frequency change keeps running the latest coefficients from
+    // updateCoefficients() until a set for the new frequency arrives.
+    void setDesignOnAudioThread(bool shouldDesign) { designOnAudioThread = shouldDesign; }
+
     float getGainReduction() const { return currentGainReduction; }
     bool isActive() const { return currentGainReduction > 0.5f; }
     bool isBypassed() const { return bypassed; }
 
 private:
-    void updateFilters();
     float processSample(float input, int channel);
 
     // Parameters
@@ -46,32 +62,101 @@ private:
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
 
-    // Biquad filter for detection band (bandpass)
-    struct BiquadState
+    // Split-band mode is a Linkwitz-Riley 4 crossover: the high band is two
+    // Butterworth high-passes in series, and low + high band is an allpass,
+    // so the output is allpass - (1 - gain) * high band and sums flat at unity
+    // gain. All filters run in two 4-lane stages, left/right in each pair of
+    // lanes, in one pass per chunk:
+    //   band stage   (on the input):            detection bandpass | high-pass 1
+    //   output stage (high-pass 1 | the input): high-pass 2        | allpass
+    // Without the high band only the detection and allpass lanes run, still
+    // in one pass (see runDetection()). Wideband and listen mode only run the
+    // detection lanes.
+    DSPUtils::BiquadLaneState bandState;
+    DSPUtils::BiquadLaneState outputState;
+
+    void runDetection(const float* leftChannel, const float* rightChannel, int numSamples);
+    void runCrossover(const float* leftChannel, const float* rightChannel, int numSamples);
+
+    // Filter outputs for the current chunk (stereo pairs): detection band,
+    // allpass (the crossover sum), high band. Sized in prepare(); longer host
+    // blocks are processed in chunks of this size.
+    enum ScratchChannel { DetectedL = 0, DetectedR, AllpassL, AllpassR, HighL, HighR, Gain, NumScratchChannels };
+    juce::AudioBuffer<float> scratchBuffer { NumScratchChannels, 512 };
+
+    // The high band is skipped while the gain is unity (it would be
+    // multiplied by zero), the allpass outside split-band mode. Recent input
+    // is kept so their filters can be re-primed when they're needed again.
+    // Sized in prepare() for the longest priming at the sample rate.
+    int historySize = 2048;  // power of two
+    juce::AudioBuffer<float> inputHistory { 2, historySize };
+    int historyWritePos = 0;
+    bool splitFiltersPrimed = false;
+    bool allpassPrimed = true;
+
+    void pushInputHistory(const float* leftChannel, const float* rightChannel, int numSamples);
+    void primeSplitFilters(bool stereo);
+    void primeAllpass(bool stereo);
+
+    template <typename Callback>
+    void replayInputHistory(bool stereo, Callback&& process);
+
+    // Filters designed for one frequency at one sample rate
+    struct CoefficientSet
     {
-        float x1 = 0.0f, x2 = 0.0f;
-        float y1 = 0.0f, y2 = 0.0f;
+        float frequency = 0.0f;
+        double sampleRate = 0.0;  // 0 marks an empty set
+
+        DSPUtils::BiquadCoeffs detection;
+        DSPUtils::BiquadCoeffs highPass;  // Each of the two high band stages
+        DSPUtils::BiquadCoeffs allPass;
+
+        // The same, laid out per lane for the two stages
+        DSPUtils::BiquadLaneCoeffs bandStage;
+        DSPUtils::BiquadLaneCoeffs outputStage;
+
+        int primeLength = 16;  // history replayed to prime the high band and allpass
     };
 
-    DSPUtils::BiquadCoeffs detectionCoeffs;
-    BiquadState detectionStateL, detectionStateR;
+    static constexpr float minFrequency = 2000.0f;
 
-    // High-pass and low-pass for split-band mode
-    DSPUtils::BiquadCoeffs highPassCoeffs;
-    DSPUtils::BiquadCoeffs lowPassCoeffs;
-    BiquadState hpStateL, hpStateR;
-    BiquadState lpStateL, lpStateR;
+    static void designCoefficients(float frequencyHz, double sampleRate, CoefficientSet& set);
+    static int getPrimeLength(const DSPUtils::BiquadCoeffs& highPass);
+    void selectCoefficients();
+
+    // Coefficients in use. Either a set designed on the audio thread or the
+    // latest one published by updateCoefficients(); chosen per block.
+    CoefficientSet localCoefficients;
+    const CoefficientSet* activeCoefficients = &localCoefficients;
+    bool designOnAudioThread = true;
+
+    DSPUtils::TripleBuffer<CoefficientSet> coefficientSets;
+    juce::SpinLock designLock;
+    float designedFrequency = 0.0f;
+    double designedSampleRate = 0.0;
 
     // Envelope follower
     float envelopeL = 0.0f;
     float envelopeR = 0.0f;
     float attackCoeff = 0.0f;
     float releaseCoeff = 0.0f;
+    float gainSmoothCoeff = 0.0f;
 
     // Gain reduction
+    float blockMaxGainReduction = 0.0f;  // Current block (see beginBlock())
     float currentGainReduction = 0.0f;
     float smoothedGainReduction = 0.0f;
     float smoothedGain = 1.0f;  // Smoothed gain for click-free de-essing
 
-    float processBiquad(float input, const DSPUtils::BiquadCoeffs& coeffs, BiquadState& state);
+    // Envelope/gain computer, shared by all kernels. Writes the smoothed gain
+    // per sample into the Gain scratch channel. Returns the max reduction in dB.
+    float computeGains(const float* detectedL, const float* detectedR, int numSamples, bool& gainIsUnity);
+
+    // Chunk kernels, specialised at compile time per mode so the per-sample
+    // loops carry no mode/listen/channel branches. Picked once per tile.
+    template <int ModeValue, bool Listen, int NumChannels>
+    float processChunk(float* leftChannel, float* rightChannel, int numSamples);
+
+    using ChunkKernel = float (DeEsser::*)(float*, float*, int);
+    static const ChunkKernel chunkKernels[2][2][2];  // [mode][listen][numChannels - 1]
 };
@@ -4,174 +4,390 @@ Equalizer::Equalizer()
 {
 }
 
-void Equalizer::prepare(double sampleRate, int /*samplesPerBlock*/)
+bool Equalizer::Parameters::operator== (const Parameters& other) const
+{
+    return hpfFreq == other.hpfFreq && hpfSlope == other.hpfSlope
+        && lowShelfFreq == other.lowShelfFreq && lowShelfGain == other.lowShelfGain
+        && lowMidFreq == other.lowMidFreq && lowMidGain == other.lowMidGain && lowMidQ == other.lowMidQ
+        && midFreq == other.midFreq && midGain == other.midGain && midQ == other.midQ
+        && highMidFreq == other.highMidFreq && highMidGain == other.highMidGain && highMidQ == other.highMidQ
+        && highShelfFreq == other.highShelfFreq && highShelfGain == other.highShelfGain;
+}
+
+void Equalizer::prepare(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
-    updateAllFilters();
+    coefficientRampSubBlocks = juce::jmax(1, juce::roundToInt(sampleRate * coefficientRampSeconds / rampSubBlockSize));
+
+    designCoefficients(params, currentSampleRate, localCoefficients);
+    activeCoefficients = &localCoefficients;
+    updateTargetCoefficients();
+
+    // Linear-phase mode, ready whichever mode is on so switching doesn't
+    // allocate. One partition per host block keeps the convolution cost the
+    // same in every callback.
+    const int length = getLinearPhaseLength(sampleRate);
+    const int partitionSize = juce::jlimit(minPartitionSize, juce::jmin(maxPartitionSize, length),
+                                           juce::nextPowerOfTwo(samplesPerBlock));
+
+    convolver.prepare(partitionSize, length);
+    localDesigner.design(params, sampleRate, partitionSize, localLinearPhase);
+    localDesigner.designDelay(sampleRate, partitionSize, delayLinearPhase);
+
+    convolver.loadFilter(bypassed ? delayLinearPhase.filter : localLinearPhase.filter, 0);
+    loadedParameters = params;
+    loadedDelay = bypassed;
+    linearPhasePartitionSize = partitionSize;
+
     reset();
 }
 
 void Equalizer::reset()
 {
-    hpf1StateL = {};
-    hpf1StateR = {};
-    hpf2StateL = {};
-    hpf2StateR = {};
-    lowShelfStateL = {};
-    lowShelfStateR = {};
-    lowMidStateL = {};
-    lowMidStateR = {};
-    midStateL = {};
-    midStateR = {};
-    highMidStateL = {};
-    highMidStateR = {};
-    highShelfStateL = {};
-    highShelfStateR = {};
+    for (auto& state : stageStates)
+        state = {};
+
+    // Start on the current coefficients, no ramp
+    runningCoeffs = targetCoeffs;
+    rampSubBlocksRemaining = 0;
+
+    convolver.reset();
 }
 
-void Equalizer::updateAllFilters()
+Equalizer::Parameters Equalizer::constrain(Parameters p)
 {
-    updateHPF();
-    updateLowShelf();
-    updateLowMid();
-    updateMid();
-    updateHighMid();
-    updateHighShelf();
+    // Same ranges as the setters
+    p.hpfFreq = std::clamp(p.hpfFreq, 20.0f, 400.0f);
+    p.hpfSlope = (p.hpfSlope >= 24) ? 24 : 12;
+    p.lowShelfFreq = std::clamp(p.lowShelfFreq, 50.0f, 500.0f);
+    p.lowShelfGain = std::clamp(p.lowShelfGain, -12.0f, 12.0f);
+    p.lowMidFreq = std::clamp(p.lowMidFreq, 100.0f, 1000.0f);
+    p.lowMidGain = std::clamp(p.lowMidGain, -12.0f, 12.0f);
+    p.lowMidQ = std::clamp(p.lowMidQ, 0.5f, 10.0f);
+    p.midFreq = std::clamp(p.midFreq, 500.0f, 4000.0f);
+    p.midGain = std::clamp(p.midGain, -12.0f, 12.0f);
+    p.midQ = std::clamp(p.midQ, 0.5f, 10.0f);
+    p.highMidFreq = std::clamp(p.highMidFreq, 2000.0f, 8000.0f);
+    p.highMidGain = std::clamp(p.highMidGain, -12.0f, 12.0f);
+    p.highMidQ = std::clamp(p.highMidQ, 0.5f, 10.0f);
+    p.highShelfFreq = std::clamp(p.highShelfFreq, 4000.0f, 16000.0f);
+    p.highShelfGain = std::clamp(p.highShelfGain, -12.0f, 12.0f);
+    return p;
 }
 
-void Equalizer::updateHPF()
+void Equalizer::designCoefficients(const Parameters& p, double sampleRate, CoefficientSet& set)
 {
+    set.parameters = p;
+    set.sampleRate = sampleRate;
+
     // Use Butterworth Q for clean response
-    hpfCoeffs1 = DSPUtils::calcHighPass(currentSampleRate, hpfFreq, 0.707f);
-    hpfCoeffs2 = DSPUtils::calcHighPass(currentSampleRate, hpfFreq, 0.707f);
+    set.hpf1 = DSPUtils::calcHighPass(sampleRate, p.hpfFreq, 0.707f);
+    set.hpf2 = DSPUtils::calcHighPass(sampleRate, p.hpfFreq, 0.707f);
+
+    set.lowShelf = DSPUtils::calcLowShelf(sampleRate, p.lowShelfFreq, p.lowShelfGain);
+    set.lowMid = DSPUtils::calcPeaking(sampleRate, p.lowMidFreq, p.lowMidGain, p.lowMidQ);
+    set.mid = DSPUtils::calcPeaking(sampleRate, p.midFreq, p.midGain, p.midQ);
+    set.highMid = DSPUtils::calcPeaking(sampleRate, p.highMidFreq, p.highMidGain, p.highMidQ);
+    set.highShelf = DSPUtils::calcHighShelf(sampleRate, p.highShelfFreq, p.highShelfGain);
 }
 
-void Equalizer::updateLowShelf()
+void Equalizer::updateCoefficients(const Parameters& newParameters, double sampleRate)
 {
-    lowShelfCoeffs = DSPUtils::calcLowShelf(currentSampleRate, lowShelfFreq, lowShelfGain);
+    const Parameters p = constrain(newParameters);
+
+    const juce::SpinLock::ScopedLockType lock(designLock);
+
+    if (p != designedParameters || sampleRate != designedSampleRate)
+    {
+        CoefficientSet& set = coefficientSets.getWriteBuffer();
+        designCoefficients(p, sampleRate, set);
+        set.version = ++displayVersion;
+
+        // The editor gets its own copy
+        displayCoefficients.getWriteBuffer() = set;
+        displayCoefficients.publish();
+        coefficientSets.publish();
+
+        designedParameters = p;
+        designedSampleRate = sampleRate;
+        designedPartitionSize = 0;
+    }
+
+    // The FIR takes far longer, so it's only designed while it's being used
+    const int partitionSize = linearPhasePartitionSize.load();
+
+    if (linearPhaseEnabled.load() && partitionSize > 0 && partitionSize != designedPartitionSize)
+    {
+        backgroundDesigner.design(p, sampleRate, partitionSize, linearPhaseSets.getWriteBuffer());
+        linearPhaseSets.publish();
+        designedPartitionSize = partitionSize;
+    }
 }
 
-void Equalizer::updateLowMid()
+void Equalizer::selectCoefficients()
 {
-    lowMidCoeffs = DSPUtils::calcPeaking(currentSampleRate, lowMidFreq, lowMidGain, lowMidQ);
+    coefficientSets.acquire();
+    const CoefficientSet& published = coefficientSets.getReadBuffer();
+
+    auto isCurrent = [this](const CoefficientSet& set)
+    {
+        return set.sampleRate == currentSampleRate && set.parameters == params;
+    };
+
+    if (isCurrent(localCoefficients))
+    {
+        activeCoefficients = &localCoefficients;
+    }
+    else if (published.sampleRate == currentSampleRate && (! designOnAudioThread || isCurrent(published)))
+    {
+        // Without audio-thread design, a stale published set keeps running
+        // until the background thread catches up
+        activeCoefficients = &published;
+    }
+    else if (designOnAudioThread)
+    {
+        designCoefficients(params, currentSampleRate, localCoefficients);
+        activeCoefficients = &localCoefficients;
+    }
+    else
+    {
+        // Nothing published for this sample rate yet: keep running the set
+        // prepare() designed for it
+        activeCoefficients = &localCoefficients;
+    }
+
+    if (updateTargetCoefficients())
+        startCoefficientRamp();
 }
 
-void Equalizer::updateMid()
+void Equalizer::selectLinearPhaseFilter()
 {
-    midCoeffs = DSPUtils::calcPeaking(currentSampleRate, midFreq, midGain, midQ);
+    // One change at a time; a newer one is picked up once this fade is done
+    if (convolver.isLoadingFilter())
+        return;
+
+    const int partitionSize = convolver.getPartitionSize();
+    const int fadePartitions = juce::jmax(1, juce::roundToInt(currentSampleRate * coefficientRampSeconds / partitionSize));
+
+    // Bypass fades to a plain delay, so the latency stays the same
+    if (bypassed)
+    {
+        if (! loadedDelay && convolver.loadFilter(delayLinearPhase.filter, fadePartitions))
+            loadedDelay = true;
+
+        return;
+    }
+
+    linearPhaseSets.acquire();
+    const LinearPhaseSet& published = linearPhaseSets.getReadBuffer();
+
+    auto fits = [this, partitionSize](const LinearPhaseSet& set)
+    {
+        return set.sampleRate == currentSampleRate && set.filter.partitionSize == partitionSize;
+    };
+
+    auto isCurrent = [this, &fits](const LinearPhaseSet& set)
+    {
+        return fits(set) && set.parameters == params;
+    };
+
+    // Same order of preference as selectCoefficients(). Without audio-thread
+    // design a stale FIR keeps running until the background thread catches up.
+    const LinearPhaseSet* selected = &localLinearPhase;
+
+    if (! isCurrent(localLinearPhase))
+    {
+        if (fits(published) && (! designOnAudioThread || isCurrent(published)))
+            selected = &published;
+        else if (designOnAudioThread)
+            localDesigner.design(params, currentSampleRate, partitionSize, localLinearPhase);
+    }
+
+    if (! fits(*selected) || (! loadedDelay && selected->parameters == loadedParameters))
+        return;
+
+    if (convolver.loadFilter(selected->filter, fadePartitions))
+    {
+        loadedParameters = selected->parameters;
+        loadedDelay = false;
+    }
+}
+
+bool Equalizer::updateTargetCoefficients()
+{
+    const CoefficientSet& c = *activeCoefficients;
+    const Parameters& p = c.parameters;
+    const DSPUtils::BiquadCoeffs passThrough;
+
+    std::array<DSPUtils::BiquadCoeffs, NumStages> targets;
+
+    // HPF (if enabled - freq > 20Hz)
+    const bool hpfEnabled = p.hpfFreq > 20.0f;
+    targets[HPF1Stage] = hpfEnabled ? c.hpf1 : passThrough;
+    targets[HPF2Stage] = hpfEnabled && p.hpfSlope >= 24 ? c.hpf2 : passThrough;
+
+    // Bands with (near) zero gain are transparent and skipped entirely
+    targets[LowShelfStage] = std::abs(p.lowShelfGain) > 0.1f ? c.lowShelf : passThrough;
+    targets[LowMidStage] = std::abs(p.lowMidGain) > 0.1f ? c.lowMid : passThrough;
+    targets[MidStage] = std::abs(p.midGain) > 0.1f ? c.mid : passThrough;
+    targets[HighMidStage] = std::abs(p.highMidGain) > 0.1f ? c.highMid : passThrough;
+    targets[HighShelfStage] = std::abs(p.highShelfGain) > 0.1f ? c.highShelf : passThrough;
+
+    if (std::memcmp(targets.data(), targetCoeffs.data(), sizeof(targets)) == 0)
+        return false;
+
+    targetCoeffs = targets;
+    return true;
 }
 
-void Equalizer::updateHighMid()
+void Equalizer::startCoefficientRamp()
 {
-    highMidCoeffs = DSPUtils::calcPeaking(currentSampleRate, highMidFreq, highMidGain, highMidQ);
+    const float scale = 1.0f / static_cast<float>(coefficientRampSubBlocks);
+
+    for (int i = 0; i < NumStages; ++i)
+    {
+        const auto& from = runningCoeffs[(size_t) i];
+        const auto& to = targetCoeffs[(size_t) i];
+        auto& step = coeffSteps[(size_t) i];
+
+        step.b0 = (to.b0 - from.b0) * scale;
+        step.b1 = (to.b1 - from.b1) * scale;
+        step.b2 = (to.b2 - from.b2) * scale;
+        step.a1 = (to.a1 - from.a1) * scale;
+        step.a2 = (to.a2 - from.a2) * scale;
+    }
+
+    rampSubBlocksRemaining = coefficientRampSubBlocks;
+    samplesUntilRampStep = 0;
 }
 
-void Equalizer::updateHighShelf()
+void Equalizer::advanceCoefficientRamp()
 {
-    highShelfCoeffs = DSPUtils::calcHighShelf(currentSampleRate, highShelfFreq, highShelfGain);
+    if (--rampSubBlocksRemaining == 0)
+    {
+        // Land exactly on the targets
+        runningCoeffs = targetCoeffs;
+        return;
+    }
+
+    for (int i = 0; i < NumStages; ++i)
+    {
+        auto& c = runningCoeffs[(size_t) i];
+        const auto& step = coeffSteps[(size_t) i];
+
+        c.b0 += step.b0;
+        c.b1 += step.b1;
+        c.b2 += step.b2;
+        c.a1 += step.a1;
+        c.a2 += step.a2;
+    }
 }
 
-float Equalizer::processBiquad(float input, const DSPUtils::BiquadCoeffs& coeffs, BiquadState& state)
+void Equalizer::buildProcessingPlan()
 {
-    float output = coeffs.b0 * input + coeffs.b1 * state.x1 + coeffs.b2 * state.x2
-                 - coeffs.a1 * state.y1 - coeffs.a2 * state.y2;
+    numPlanStages = 0;
 
-    state.x2 = state.x1;
-    state.x1 = input;
-    state.y2 = state.y1;
-    state.y1 = output;
+    auto isPassThrough = [](const DSPUtils::BiquadCoeffs& c)
+    {
+        return c.b0 == 1.0f && c.b1 == 0.0f && c.b2 == 0.0f && c.a1 == 0.0f && c.a2 == 0.0f;
+    };
+
+    // A stage being ramped in or out runs until its ramp is done
+    for (int i = 0; i < NumStages; ++i)
+    {
+        if (! isPassThrough(runningCoeffs[(size_t) i]) || ! isPassThrough(targetCoeffs[(size_t) i]))
+            plan[(size_t) numPlanStages++] = i;
+    }
+}
 
-    return output;
+void Equalizer::processPlan(float* leftChannel, float* rightChannel, int numSamples)
+{
+    for (int i = 0; i < numPlanStages; ++i)
+    {
+        const int stage = plan[(size_t) i];
+        DSPUtils::processBiquad(leftChannel, rightChannel, numSamples, runningCoeffs[(size_t) stage], stageStates[(size_t) stage]);
+    }
 }
 
 // Parameter setters
 void Equalizer::setHPFFrequency(float freq)
 {
-    hpfFreq = std::clamp(freq, 20.0f, 400.0f);
-    updateHPF();
+    params.hpfFreq = std::clamp(freq, 20.0f, 400.0f);
 }
 
 void Equalizer::setHPFSlope(int slope)
 {
-    hpfSlope = (slope >= 24) ? 24 : 12;
+    params.hpfSlope = (slope >= 24) ? 24 : 12;
 }
 
 void Equalizer::setLowShelfFrequency(float freq)
 {
-    lowShelfFreq = std::clamp(freq, 50.0f, 500.0f);
-    updateLowShelf();
+    params.lowShelfFreq = std::clamp(freq, 50.0f, 500.0f);
 }
 
 void Equalizer::setLowShelfGain(float gainDb)
 {
-    lowShelfGain = std::clamp(gainDb, -12.0f, 12.0f);
-    updateLowShelf();
+    params.lowShelfGain = std::clamp(gainDb, -12.0f, 12.0f);
 }
 
 void Equalizer::setLowMidFrequency(float freq)
 {
-    lowMidFreq = std::clamp(freq, 100.0f, 1000.0f);
-    updateLowMid();
+    params.lowMidFreq = std::clamp(freq, 100.0f, 1000.0f);
 }
 
 void Equalizer::setLowMidGain(float gainDb)
 {
-    lowMidGain = std::clamp(gainDb, -12.0f, 12.0f);
-    updateLowMid();
+    params.lowMidGain = std::clamp(gainDb, -12.0f, 12.0f);
 }
 
 void Equalizer::setLowMidQ(float q)
 {
-    lowMidQ = std::clamp(q, 0.5f, 10.0f);
-    updateLowMid();
+    params.lowMidQ = std::clamp(q, 0.5f, 10.0f);
 }
 
 void Equalizer::setMidFrequency(float freq)
 {
-    midFreq = std::clamp(freq, 500.0f, 4000.0f);
-    updateMid();
+    params.midFreq = std::clamp(freq, 500.0f, 4000.0f);
 }
 
 void Equalizer::setMidGain(float gainDb)
 {
-    midGain = std::clamp(gainDb, -12.0f, 12.0f);
-    updateMid();
+    params.midGain = std::clamp(gainDb, -12.0f, 12.0f);
 }
 
 void Equalizer::setMidQ(float q)
 {
-    midQ = std::clamp(q, 0.5f, 10.0f);
-    updateMid();
+    params.midQ = std::clamp(q, 0.5f, 10.0f);
 }
 
 void Equalizer::setHighMidFrequency(float freq)
 {
-    highMidFreq = std::clamp(freq, 2000.0f, 8000.0f);
-    updateHighMid();
+    params.highMidFreq = std::clamp(freq, 2000.0f, 8000.0f);
 }
 
 void Equalizer::setHighMidGain(float gainDb)
 {
-    highMidGain = std::clamp(gainDb, -12.0f, 12.0f);
-    updateHighMid();
+    params.highMidGain = std::clamp(gainDb, -12.0f, 12.0f);
 }
 
 void Equalizer::setHighMidQ(float q)
 {
-    highMidQ = std::clamp(q, 0.5f, 10.0f);
-    updateHighMid();
+    params.highMidQ = std::clamp(q, 0.5f, 10.0f);
 }
 
 void Equalizer::setHighShelfFrequency(float freq)
 {
-    highShelfFreq = std::clamp(freq, 4000.0f, 16000.0f);
-    updateHighShelf();
+    params.highShelfFreq = std::clamp(freq, 4000.0f, 16000.0f);
 }
 
 void Equalizer::setHighShelfGain(float gainDb)
 {
-    highShelfGain = std::clamp(gainDb, -12.0f, 12.0f);
-    updateHighShelf();
+    params.highShelfGain = std::clamp(gainDb, -12.0f, 12.0f);
+}
+
+void Equalizer::setParameters(const Parameters& newParameters)
+{
+    params = constrain(newParameters);
 }
 
 void Equalizer::setBypass(bool shouldBypass)
@@ -179,182 +395,275 @@ void Equalizer::setBypass(bool shouldBypass)
     bypassed = shouldBypass;
 }
 
-float Equalizer::getMagnitudeAtFrequency(float freq) const
+void Equalizer::setLinearPhase(bool shouldBeLinearPhase)
+{
+    if (shouldBeLinearPhase == linearPhase)
+        return;
+
+    linearPhase = shouldBeLinearPhase;
+    linearPhaseEnabled = shouldBeLinearPhase;
+
+    // The mode not running has stale state; start the new one clean
+    reset();
+}
+
+int Equalizer::getLinearPhaseLength(double sampleRate)
+{
+    return juce::nextPowerOfTwo(static_cast<int>(std::ceil(sampleRate * linearPhaseSeconds)));
+}
+
+int Equalizer::getLinearPhaseLatencySamples(double sampleRate)
 {
-    // Calculate combined magnitude response at a given frequency
-    // This is used for the EQ visualization
+    return getLinearPhaseLength(sampleRate) / 2 - 1;
+}
 
-    float w = 2.0f * juce::MathConstants<float>::pi * freq / static_cast<float>(currentSampleRate);
-    float cosw = std::cos(w);
-    float cos2w = std::cos(2.0f * w);
-    float sinw = std::sin(w);
-    float sin2w = std::sin(2.0f * w);
+void Equalizer::LinearPhaseDesigner::prepare(double sampleRate, int partitionSize)
+{
+    // The magnitudes are sampled at twice the FIR length, so the windowing
+    // below cuts off only the decayed ends of the zero-phase impulse
+    const int length = getLinearPhaseLength(sampleRate);
+    const int designSize = 2 * length;
 
-    auto calcMagnitude = [&](const DSPUtils::BiquadCoeffs& c) -> float
+    if (fft == nullptr || fft->getSize() != designSize)
     {
-        float numReal = c.b0 + c.b1 * cosw + c.b2 * cos2w;
-        float numImag = -c.b1 * sinw - c.b2 * sin2w;
-        float denReal = 1.0f + c.a1 * cosw + c.a2 * cos2w;
-        float denImag = -c.a1 * sinw - c.a2 * sin2w;
+        fft = std::make_unique<juce::dsp::FFT>(juce::roundToInt(std::log2(designSize)));
+        data.assign((size_t) (2 * designSize), 0.0f);
+        impulse.assign((size_t) length, 0.0f);
+    }
 
-        float numMag = std::sqrt(numReal * numReal + numImag * numImag);
-        float denMag = std::sqrt(denReal * denReal + denImag * denImag);
+    if (partitionFFT == nullptr || partitionFFT->getSize() != 2 * partitionSize)
+        partitionFFT = std::make_unique<juce::dsp::FFT>(juce::roundToInt(std::log2(2 * partitionSize)));
 
-        return numMag / denMag;
-    };
+    if (grid.sampleRate != sampleRate || grid.getNumPoints() != length + 1)
+    {
+        frequencies.resize((size_t) (length + 1));
+
+        for (int k = 0; k <= length; ++k)
+            frequencies[(size_t) k] = static_cast<float>(k * sampleRate / designSize);
+
+        grid.setFrequencies(frequencies.data(), length + 1, sampleRate);
+        magnitudes.resize(frequencies.size());
+        bandMagnitudes.resize(frequencies.size());
+    }
+}
+
+void Equalizer::LinearPhaseDesigner::design(const Parameters& p, double sampleRate, int partitionSize, LinearPhaseSet& set)
+{
+    prepare(sampleRate, partitionSize);
+    designCoefficients(p, sampleRate, coefficients);
 
-    float magnitude = 1.0f;
+    // Combined magnitude of the enabled bands, the same curve the editor draws
+    const int numBins = grid.getNumPoints();
+    std::fill(magnitudes.begin(), magnitudes.end(), 1.0f);
 
-    // HPF (apply once or twice depending on slope)
-    if (hpfFreq > 20.0f)
+    for (int band = 0; band < NumBands; ++band)
     {
-        magnitude *= calcMagnitude(hpfCoeffs1);
-        if (hpfSlope >= 24)
-            magnitude *= calcMagnitude(hpfCoeffs2);
+        if (! coefficients.isBandEnabled(band))
+            continue;
+
+        coefficients.getBandMagnitudes(grid, band, bandMagnitudes.data());
+        juce::FloatVectorOperations::multiply(magnitudes.data(), bandMagnitudes.data(), numBins);
     }
 
-    // All other bands
-    if (std::abs(lowShelfGain) > 0.1f)
-        magnitude *= calcMagnitude(lowShelfCoeffs);
+    // Zero phase: real bins, giving an impulse symmetric around sample 0
+    std::fill(data.begin(), data.end(), 0.0f);
+
+    for (int k = 0; k < numBins; ++k)
+        data[(size_t) (2 * k)] = magnitudes[(size_t) k];
 
-    if (std::abs(lowMidGain) > 0.1f)
-        magnitude *= calcMagnitude(lowMidCoeffs);
+    fft->performRealOnlyInverseTransform(data.data());
 
-    if (std::abs(midGain) > 0.1f)
-        magnitude *= calcMagnitude(midCoeffs);
+    // Rotate it to the centre tap and taper the ends (Tukey window, flat over
+    // the middle half). The last tap falls outside the window and stays 0.
+    const int designSize = fft->getSize();
+    const int length = static_cast<int>(impulse.size());
+    const int centre = length / 2 - 1;
 
-    if (std::abs(highMidGain) > 0.1f)
-        magnitude *= calcMagnitude(highMidCoeffs);
+    for (int t = 0; t < length; ++t)
+    {
+        const float x = std::abs(static_cast<float>(t - centre) / static_cast<float>(centre));
+        const float window = x <= 0.5f ? 1.0f
+                           : x < 1.0f ? 0.5f + 0.5f * std::cos(juce::MathConstants<float>::twoPi * (x - 0.5f))
+                                      : 0.0f;
 
-    if (std::abs(highShelfGain) > 0.1f)
-        magnitude *= calcMagnitude(highShelfCoeffs);
+        impulse[(size_t) t] = data[(size_t) ((t - centre + designSize) % designSize)] * window;
+    }
 
-    return magnitude;
+    set.filter.design(impulse.data(), length, partitionSize, *partitionFFT);
+    set.parameters = p;
+    set.sampleRate = sampleRate;
 }
 
-float Equalizer::getBandMagnitudeAtFrequency(float freq, int bandIndex) const
+void Equalizer::LinearPhaseDesigner::designDelay(double sampleRate, int partitionSize, LinearPhaseSet& set)
 {
-    // Calculate magnitude for a single EQ band
-    float w = 2.0f * juce::MathConstants<float>::pi * freq / static_cast<float>(currentSampleRate);
-    float cosw = std::cos(w);
-    float cos2w = std::cos(2.0f * w);
-    float sinw = std::sin(w);
-    float sin2w = std::sin(2.0f * w);
+    prepare(sampleRate, partitionSize);
+
+    std::fill(impulse.begin(), impulse.end(), 0.0f);
+    impulse[impulse.size() / 2 - 1] = 1.0f;
 
-    auto calcMagnitude = [&](const DSPUtils::BiquadCoeffs& c) -> float
+    set.filter.design(impulse.data(), static_cast<int>(impulse.size()), partitionSize, *partitionFFT);
+    set.parameters = {};
+    set.sampleRate = sampleRate;
+}
+
+void Equalizer::ResponseGrid::setFrequencies(const float* frequencies, int numPoints, double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    cosw.resize((size_t) numPoints);
+    sinw.resize((size_t) numPoints);
+    cos2w.resize((size_t) numPoints);
+    sin2w.resize((size_t) numPoints);
+
+    // An empty grid (no sample rate yet) evaluates to garbage-free DC
+    const double radiansPerHz = sampleRate > 0.0 ? 2.0 * juce::MathConstants<double>::pi / sampleRate : 0.0;
+
+    for (int i = 0; i < numPoints; ++i)
     {
-        float numReal = c.b0 + c.b1 * cosw + c.b2 * cos2w;
-        float numImag = -c.b1 * sinw - c.b2 * sin2w;
-        float denReal = 1.0f + c.a1 * cosw + c.a2 * cos2w;
-        float denImag = -c.a1 * sinw - c.a2 * sin2w;
+        const double w = radiansPerHz * frequencies[i];
+        cosw[(size_t) i] = static_cast<float>(std::cos(w));
+        sinw[(size_t) i] = static_cast<float>(std::sin(w));
+        cos2w[(size_t) i] = static_cast<float>(std::cos(2.0 * w));
+        sin2w[(size_t) i] = static_cast<float>(std::sin(2.0 * w));
+    }
+}
 
-        float numMag = std::sqrt(numReal * numReal + numImag * numImag);
-        float denMag = std::sqrt(denReal * denReal + denImag * denImag);
+bool Equalizer::CoefficientSet::isBandEnabled(int bandIndex) const
+{
+    switch (bandIndex)
+    {
+        case HPF:       return parameters.hpfFreq > 20.0f;
+        case LowShelf:  return std::abs(parameters.lowShelfGain) > 0.1f;
+        case LowMid:    return std::abs(parameters.lowMidGain) > 0.1f;
+        case Mid:       return std::abs(parameters.midGain) > 0.1f;
+        case HighMid:   return std::abs(parameters.highMidGain) > 0.1f;
+        case HighShelf: return std::abs(parameters.highShelfGain) > 0.1f;
+        default:        return false;
+    }
+}
 
-        return numMag / denMag;
+bool Equalizer::CoefficientSet::hasSameBand(const CoefficientSet& other, int bandIndex) const
+{
+    auto same = [](const DSPUtils::BiquadCoeffs& a, const DSPUtils::BiquadCoeffs& b)
+    {
+        return a.b0 == b.b0 && a.b1 == b.b1 && a.b2 == b.b2 && a.a1 == b.a1 && a.a2 == b.a2;
     };
 
+    if (sampleRate != other.sampleRate || isBandEnabled(bandIndex) != other.isBandEnabled(bandIndex))
+        return false;
+
     switch (bandIndex)
     {
         case HPF:
-            if (hpfFreq > 20.0f)
-            {
-                float mag = calcMagnitude(hpfCoeffs1);
-                if (hpfSlope >= 24)
-                    mag *= calcMagnitude(hpfCoeffs2);
-                return mag;
-            }
-            return 1.0f;
-
-        case LowShelf:
-            return calcMagnitude(lowShelfCoeffs);
+            return ! isBandEnabled(HPF)
+                || (parameters.hpfSlope == other.parameters.hpfSlope && same(hpf1, other.hpf1) && same(hpf2, other.hpf2));
+
+        case LowShelf:  return same(lowShelf, other.lowShelf);
+        case LowMid:    return same(lowMid, other.lowMid);
+        case Mid:       return same(mid, other.mid);
+        case HighMid:   return same(highMid, other.highMid);
+        case HighShelf: return same(highShelf, other.highShelf);
+        default:        return true;
+    }
+}
 
-        case LowMid:
-            return calcMagnitude(lowMidCoeffs);
+void Equalizer::CoefficientSet::getBandMagnitudes(const ResponseGrid& grid, int bandIndex, float* magnitudes) const
+{
+    const int numPoints = grid.getNumPoints();
+    std::fill(magnitudes, magnitudes + numPoints, 1.0f);
 
-        case Mid:
-            return calcMagnitude(midCoeffs);
+    if (sampleRate <= 0.0)
+        return;
 
-        case HighMid:
-            return calcMagnitude(highMidCoeffs);
+    jassert(grid.sampleRate == sampleRate);
 
-        case HighShelf:
-            return calcMagnitude(highShelfCoeffs);
+    auto apply = [&](const DSPUtils::BiquadCoeffs& c)
+    {
+        DSPUtils::multiplyByBiquadMagnitude(c, grid.cosw.data(), grid.sinw.data(), grid.cos2w.data(), grid.sin2w.data(),
+                                            magnitudes, numPoints);
+    };
 
-        default:
-            return 1.0f;
+    switch (bandIndex)
+    {
+        case HPF:
+            // Flat when off; applied once or twice depending on slope
+            if (isBandEnabled(HPF))
+            {
+                apply(hpf1);
+                if (parameters.hpfSlope >= 24)
+                    apply(hpf2);
+            }
+            break;
+
+        case LowShelf:  apply(lowShelf); break;
+        case LowMid:    apply(lowMid); break;
+        case Mid:       apply(mid); break;
+        case HighMid:   apply(highMid); break;
+        case HighShelf: apply(highShelf); break;
+        default:        break;
     }
 }
 
 void Equalizer::process(juce::AudioBuffer<float>& buffer)
 {
-    if (bypassed)
-        return;
-
     const int numChannels = buffer.getNumChannels();
-    const int numSamples = buffer.getNumSamples();
 
-    if (numChannels == 0)
+    if (numChannels == 0 || ! beginBlock())
         return;
 
-    float* leftChannel = buffer.getWritePointer(0);
-    float* rightChannel = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
+    processTile(buffer.getWritePointer(0), numChannels > 1 ? buffer.getWritePointer(1) : nullptr,
+                buffer.getNumSamples());
+}
 
-    for (int i = 0; i < numSamples; ++i)
+bool Equalizer::beginBlock()
+{
+    if (linearPhase)
     {
-        float sampleL = leftChannel[i];
-        float sampleR = rightChannel ? rightChannel[i] : sampleL;
+        selectLinearPhaseFilter();
+        return true;
+    }
 
-        // HPF (if enabled - freq > 20Hz)
-        if (hpfFreq > 20.0f)
-        {
-            sampleL = processBiquad(sampleL, hpfCoeffs1, hpf1StateL);
-            sampleR = processBiquad(sampleR, hpfCoeffs1, hpf1StateR);
+    if (bypassed)
+        return false;
 
-            if (hpfSlope >= 24)
-            {
-                sampleL = processBiquad(sampleL, hpfCoeffs2, hpf2StateL);
-                sampleR = processBiquad(sampleR, hpfCoeffs2, hpf2StateR);
-            }
-        }
+    selectCoefficients();
 
-        // Low Shelf
-        if (std::abs(lowShelfGain) > 0.1f)
-        {
-            sampleL = processBiquad(sampleL, lowShelfCoeffs, lowShelfStateL);
-            sampleR = processBiquad(sampleR, lowShelfCoeffs, lowShelfStateR);
-        }
+    // Band-major: decide once per block which filters run, then run each
+    // active filter over the whole block (signal-flow order is preserved)
+    buildProcessingPlan();
+    return true;
+}
 
-        // Low-Mid Parametric
-        if (std::abs(lowMidGain) > 0.1f)
-        {
-            sampleL = processBiquad(sampleL, lowMidCoeffs, lowMidStateL);
-            sampleR = processBiquad(sampleR, lowMidCoeffs, lowMidStateR);
-        }
+void Equalizer::processTile(float* leftChannel, float* rightChannel, int numSamples)
+{
+    if (linearPhase)
+    {
+        convolver.process(leftChannel, rightChannel, numSamples);
+        return;
+    }
 
-        // Mid Parametric
-        if (std::abs(midGain) > 0.1f)
-        {
-            sampleL = processBiquad(sampleL, midCoeffs, midStateL);
-            sampleR = processBiquad(sampleR, midCoeffs, midStateR);
-        }
+    if (rampSubBlocksRemaining == 0)
+    {
+        processPlan(leftChannel, rightChannel, numSamples);
+        return;
+    }
 
-        // High-Mid Parametric
-        if (std::abs(highMidGain) > 0.1f)
+    // Ramping: step the coefficients every rampSubBlockSize samples, counted
+    // across host blocks so the ramp doesn't depend on the block size. Once
+    // it lands, the rest of the block runs in one go.
+    for (int start = 0; start < numSamples;)
+    {
+        if (rampSubBlocksRemaining > 0 && samplesUntilRampStep == 0)
         {
-            sampleL = processBiquad(sampleL, highMidCoeffs, highMidStateL);
-            sampleR = processBiquad(sampleR, highMidCoeffs, highMidStateR);
+            advanceCoefficientRamp();
+            samplesUntilRampStep = rampSubBlockSize;
         }
 
-        // High Shelf
-        if (std::abs(highShelfGain) > 0.1f)
-        {
-            sampleL = processBiquad(sampleL, highShelfCoeffs, highShelfStateL);
-            sampleR = processBiquad(sampleR, highShelfCoeffs, highShelfStateR);
-        }
+        const int numThisTime = rampSubBlocksRemaining > 0 ? std::min(samplesUntilRampStep, numSamples - start)
+                                                           : numSamples - start;
+
+        processPlan(leftChannel + start, rightChannel != nullptr ? rightChannel + start : nullptr, numThisTime);
 
-        leftChannel[i] = sampleL;
-        if (rightChannel)
-            rightChannel[i] = sampleR;
+        samplesUntilRampStep -= numThisTime;
+        start += numThisTime;
     }
 }
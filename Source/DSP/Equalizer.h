@@ -2,6 +2,7 @@
 
 #include <JuceHeader.h>
 #include "DSPUtils.h"
+#include "PartitionedConvolver.h"
 
 class Equalizer
 {
@@ -18,10 +19,85 @@ public:
         NumBands
     };
 
+    // Filter settings (everything the biquad design depends on)
+    struct Parameters
+    {
+        float hpfFreq = 80.0f;
+        int hpfSlope = 12;  // 12 or 24 dB/oct
+
+        float lowShelfFreq = 200.0f;
+        float lowShelfGain = 0.0f;
+
+        float lowMidFreq = 400.0f;
+        float lowMidGain = 0.0f;
+        float lowMidQ = 1.0f;
+
+        float midFreq = 1000.0f;
+        float midGain = 0.0f;
+        float midQ = 1.0f;
+
+        float highMidFreq = 4000.0f;
+        float highMidGain = 0.0f;
+        float highMidQ = 1.0f;
+
+        float highShelfFreq = 8000.0f;
+        float highShelfGain = 0.0f;
+
+        bool operator== (const Parameters& other) const;
+        bool operator!= (const Parameters& other) const { return ! (*this == other); }
+    };
+
+    // cos/sin of w and 2w for a fixed set of frequencies, shared by every
+    // response evaluated on them. Rebuild when the frequencies or the sample
+    // rate change. Not real-time safe (allocates).
+    struct ResponseGrid
+    {
+        void setFrequencies(const float* frequencies, int numPoints, double newSampleRate);
+        int getNumPoints() const { return static_cast<int>(cosw.size()); }
+
+        double sampleRate = 0.0;
+        std::vector<float> cosw, sinw, cos2w, sin2w;
+    };
+
+    // Biquads designed for one set of parameters at one sample rate
+    struct CoefficientSet
+    {
+        Parameters parameters;
+        double sampleRate = 0.0;  // 0 marks an empty set
+        juce::uint32 version = 0; // Sets published for display count up from 1
+
+        DSPUtils::BiquadCoeffs hpf1;
+        DSPUtils::BiquadCoeffs hpf2;  // Second stage for 24dB slope
+        DSPUtils::BiquadCoeffs lowShelf;
+        DSPUtils::BiquadCoeffs lowMid;
+        DSPUtils::BiquadCoeffs mid;
+        DSPUtils::BiquadCoeffs highMid;
+        DSPUtils::BiquadCoeffs highShelf;
+
+        // Frequency response of one band for visualization, one magnitude per
+        // grid point. The grid must match this sample rate.
+        void getBandMagnitudes(const ResponseGrid& grid, int bandIndex, float* magnitudes) const;
+
+        // Whether a band is processed, i.e. part of the combined response
+        // (HPF above 20 Hz, other bands away from 0 dB)
+        bool isBandEnabled(int bandIndex) const;
+
+        // Whether a band has the same response in both sets, so a cached
+        // curve for it is still valid
+        bool hasSameBand(const CoefficientSet& other, int bandIndex) const;
+    };
+
     Equalizer();
 
     void prepare(double sampleRate, int samplesPerBlock);
     void process(juce::AudioBuffer<float>& buffer);
+
+    // Tile-wise processing for the processor's chain scheduler: beginBlock()
+    // once per host block (false when bypassed, unless linear-phase mode has
+    // to keep its delay), then processTile() over
+    // consecutive stretches of it. Same result as process() on the whole block.
+    bool beginBlock();
+    void processTile(float* leftChannel, float* rightChannel, int numSamples);
     void reset();
 
     // HPF parameters
@@ -51,76 +127,148 @@ public:
     void setHighShelfFrequency(float freq);  // 4kHz to 16kHz
     void setHighShelfGain(float gainDb);     // -12 to +12 dB
 
+    void setParameters(const Parameters& newParameters);  // All filter settings at once
+
     void setBypass(bool shouldBypass);
     bool isBypassed() const { return bypassed; }
 
-    // Get frequency response for visualization (returns magnitude at given frequency)
-    float getMagnitudeAtFrequency(float freq) const;
-    float getBandMagnitudeAtFrequency(float freq, int bandIndex) const;
+    // Linear-phase mode: the magnitude response of the biquads without their
+    // phase shift, as an FIR run through a partitioned FFT convolver whose
+    // partitions follow the block size given to prepare(). Delays the signal
+    // by getLinearPhaseLatencySamples(), bypassed or not. Settings changes
+    // and bypass crossfade between filters.
+    void setLinearPhase(bool shouldBeLinearPhase);
+    bool isLinearPhase() const { return linearPhase; }
+    static int getLinearPhaseLatencySamples(double sampleRate);
+    int getLatencySamples() const { return linearPhase ? getLinearPhaseLatencySamples(currentSampleRate) : 0; }
 
-private:
-    void updateAllFilters();
-    void updateHPF();
-    void updateLowShelf();
-    void updateLowMid();
-    void updateMid();
-    void updateHighMid();
-    void updateHighShelf();
-
-    struct BiquadState
+    // Designs the filters for these settings and hands them to the audio
+    // thread, the linear-phase FIR too while that mode is on. Not real-time
+    // safe: call from a background thread. Does nothing if the settings match
+    // the last set designed.
+    void updateCoefficients(const Parameters& newParameters, double sampleRate);
+
+    // With this off, process() never designs filters itself once prepared:
+    // after a parameter change it keeps running the latest coefficients (or
+    // FIR) from updateCoefficients() until a set for the new settings
+    // arrives. On by default, so the setters take effect in the next
+    // process() call.
+    void setDesignOnAudioThread(bool shouldDesign) { designOnAudioThread = shouldDesign; }
+
+    // The latest set designed by updateCoefficients(), for drawing the
+    // response. Never touches the filters the audio thread is running. Call
+    // from one thread only (the message thread); the set stays valid until
+    // the next call. Compare its version to see whether anything changed.
+    const CoefficientSet& getDisplayCoefficients()
     {
-        float x1 = 0.0f, x2 = 0.0f;
-        float y1 = 0.0f, y2 = 0.0f;
-    };
+        displayCoefficients.acquire();
+        return displayCoefficients.getReadBuffer();
+    }
 
-    float processBiquad(float input, const DSPUtils::BiquadCoeffs& coeffs, BiquadState& state);
 
-    // Parameters
-    // HPF
-    float hpfFreq = 80.0f;
-    int hpfSlope = 12;  // 12 or 24 dB/oct
+private:
+    static Parameters constrain(Parameters p);
+    static void designCoefficients(const Parameters& p, double sampleRate, CoefficientSet& set);
+    void selectCoefficients();
 
-    // Low Shelf
-    float lowShelfFreq = 200.0f;
-    float lowShelfGain = 0.0f;
+    // Filter stages in signal-flow order
+    enum Stage { HPF1Stage = 0, HPF2Stage, LowShelfStage, LowMidStage, MidStage, HighMidStage, HighShelfStage, NumStages };
 
-    // Low-Mid (parametric)
-    float lowMidFreq = 400.0f;
-    float lowMidGain = 0.0f;
-    float lowMidQ = 1.0f;
+    // Per-stage coefficients for the active set: disabled stages (HPF off,
+    // second HPF stage at 12 dB/oct, bands at ~0 dB) get a pass-through.
+    // Returns true if they differ from the current targets.
+    bool updateTargetCoefficients();
 
-    // Mid (parametric)
-    float midFreq = 1000.0f;
-    float midGain = 0.0f;
-    float midQ = 1.0f;
+    // When the coefficients change, every stage moves linearly from its running
+    // coefficients to the new targets over coefficientRampSubBlocks sub-blocks
+    // of rampSubBlockSize samples, instead of jumping at the block boundary.
+    static constexpr int rampSubBlockSize = 32;
+    static constexpr double coefficientRampSeconds = 0.01;
+    int coefficientRampSubBlocks = 1;
+    int rampSubBlocksRemaining = 0;
+    int samplesUntilRampStep = 0;
 
-    // High-Mid (parametric)
-    float highMidFreq = 4000.0f;
-    float highMidGain = 0.0f;
-    float highMidQ = 1.0f;
+    std::array<DSPUtils::BiquadCoeffs, NumStages> targetCoeffs;
+    std::array<DSPUtils::BiquadCoeffs, NumStages> runningCoeffs;
+    std::array<DSPUtils::BiquadCoeffs, NumStages> coeffSteps;
 
-    // High Shelf
-    float highShelfFreq = 8000.0f;
-    float highShelfGain = 0.0f;
+    void startCoefficientRamp();
+    void advanceCoefficientRamp();
 
-    bool bypassed = false;
+    // Per-block processing plan: only the stages that are not pass-through
+    // (at either end of a ramp), in signal-flow order. Rebuilt at the start of
+    // every block (process() or beginBlock()).
+    std::array<int, NumStages> plan {};
+    int numPlanStages = 0;
+
+    void buildProcessingPlan();
+    void processPlan(float* leftChannel, float* rightChannel, int numSamples);
 
-    // Coefficients
+    // Parameters
+    Parameters params;
+    bool bypassed = false;
     double currentSampleRate = 44100.0;
-    DSPUtils::BiquadCoeffs hpfCoeffs1;
-    DSPUtils::BiquadCoeffs hpfCoeffs2;  // Second stage for 24dB slope
-    DSPUtils::BiquadCoeffs lowShelfCoeffs;
-    DSPUtils::BiquadCoeffs lowMidCoeffs;
-    DSPUtils::BiquadCoeffs midCoeffs;
-    DSPUtils::BiquadCoeffs highMidCoeffs;
-    DSPUtils::BiquadCoeffs highShelfCoeffs;
-
-    // State (stereo)
-    BiquadState hpf1StateL, hpf1StateR;
-    BiquadState hpf2StateL, hpf2StateR;
-    BiquadState lowShelfStateL, lowShelfStateR;
-    BiquadState lowMidStateL, lowMidStateR;
-    BiquadState midStateL, midStateR;
-    BiquadState highMidStateL, highMidStateR;
-    BiquadState highShelfStateL, highShelfStateR;
+
+    // Coefficients in use. Either a set designed on the audio thread or the
+    // latest one published by updateCoefficients(); chosen per block.
+    CoefficientSet localCoefficients;
+    const CoefficientSet* activeCoefficients = &localCoefficients;
+    bool designOnAudioThread = true;
+
+    DSPUtils::TripleBuffer<CoefficientSet> coefficientSets;
+    juce::SpinLock designLock;
+    Parameters designedParameters;
+    double designedSampleRate = 0.0;
+
+    DSPUtils::TripleBuffer<CoefficientSet> displayCoefficients;
+    juce::uint32 displayVersion = 0;
+
+    // State (stereo - left and right run in SIMD lanes)
+    std::array<DSPUtils::BiquadLaneState, NumStages> stageStates;
+
+    // Linear-phase mode. The FIR is designed by frequency sampling the biquad
+    // magnitudes, windowed to linearPhaseSeconds (rounded up to a power of
+    // two) and centred on tap length / 2 - 1, which is its delay.
+    static constexpr double linearPhaseSeconds = 0.17;
+    static constexpr int minPartitionSize = 64;
+    static constexpr int maxPartitionSize = 4096;
+    static int getLinearPhaseLength(double sampleRate);
+
+    // An FIR designed for one set of parameters, sample rate and partition size
+    struct LinearPhaseSet
+    {
+        Parameters parameters;
+        double sampleRate = 0.0;  // 0 marks an empty set
+        PartitionedConvolver::Filter filter;
+    };
+
+    // FFTs and work buffers for the design; one per designing thread
+    struct LinearPhaseDesigner
+    {
+        void design(const Parameters& p, double sampleRate, int partitionSize, LinearPhaseSet& set);
+        void designDelay(double sampleRate, int partitionSize, LinearPhaseSet& set);  // Flat, for bypass
+
+        std::unique_ptr<juce::dsp::FFT> fft, partitionFFT;
+        ResponseGrid grid;
+        CoefficientSet coefficients;
+        std::vector<float> frequencies, magnitudes, bandMagnitudes, data, impulse;
+
+        void prepare(double sampleRate, int partitionSize);  // Allocates only when the sizes change
+    };
+
+    void selectLinearPhaseFilter();
+
+    bool linearPhase = false;
+    std::atomic<bool> linearPhaseEnabled { false };   // For the design thread
+    std::atomic<int> linearPhasePartitionSize { 0 };  // Set by prepare(), for the design thread
+    int designedPartitionSize = 0;                    // Of the last FIR published; 0 = none since the last settings change
+
+    PartitionedConvolver convolver;
+    LinearPhaseDesigner localDesigner, backgroundDesigner;
+    LinearPhaseSet localLinearPhase, delayLinearPhase;
+    DSPUtils::TripleBuffer<LinearPhaseSet> linearPhaseSets;
+
+    // What the convolver is running (or fading to)
+    Parameters loadedParameters;
+    bool loadedDelay = false;
 };
@@ -0,0 +1,599 @@
+#include "Oversampler.h"
+
+namespace
+{
+    // Stage designs, first (lowest rate) stage first. Later stages only have
+    // to reject images of the original band, so they get by with far wider
+    // transitions. Both sets keep the images at least 90 dB down with the
+    // passband flat to within 0.01 dB up to 0.43 of the base rate.
+    struct FIRStageDesign { int halfLength; double attenuationDb; };
+    constexpr FIRStageDesign firStageDesigns[Oversampler::maxFactorLog2] = { { 23, 96.0 }, { 6, 96.0 }, { 3, 96.0 } };
+
+    struct IIRStageDesign { int numCoefficients; double transitionBandwidth; };
+    constexpr IIRStageDesign iirStageDesigns[Oversampler::maxFactorLog2] = { { 12, 0.035 }, { 4, 0.18 }, { 4, 0.28 } };
+
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; term > sum * 1.0e-12; ++k)
+        {
+            const double half = x / (2.0 * k);
+            term *= half * half;
+            sum += term;
+        }
+
+        return sum;
+    }
+}
+
+void Oversampler::Stage::reset()
+{
+    upWork.clear();
+    downEvenWork.clear();
+    downOddWork.clear();
+
+    for (auto* sections : { &upSections, &downSections })
+    {
+        for (auto& section : *sections)
+        {
+            std::fill(std::begin(section.x), std::end(section.x), 0.0f);
+            std::fill(std::begin(section.y), std::end(section.y), 0.0f);
+        }
+    }
+}
+
+void Oversampler::prepare(int factorLog2, FilterType type, int maxSamplesPerBlock)
+{
+    const int numStages = std::clamp(factorLog2, 0, maxFactorLog2);
+    filterType = type;
+    maxBlockSize = juce::jmax(1, maxSamplesPerBlock);
+
+    stages.assign((size_t) numStages, Stage());
+    rateBuffers.assign((size_t) numStages + 1, juce::AudioBuffer<float>());
+
+    for (int s = 0; s <= numStages; ++s)
+        rateBuffers[(size_t) s].setSize(2, s > 0 ? maxBlockSize << s : 0);
+
+    // Latency, in top-rate samples until the end
+    const int factor = 1 << numStages;
+    double latency = 0.0;
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        Stage& stage = stages[(size_t) s];
+
+        if (type == LinearPhase)
+        {
+            designFIRStage(stage, firStageDesigns[s].halfLength, firStageDesigns[s].attenuationDb, maxBlockSize << s);
+
+            // Up and down each delay by half the filter length at this stage's
+            // upper rate: (4K + 2) / 2 samples
+            latency += static_cast<double>((4 * stage.halfDelay + 2) << (numStages - 1 - s));
+        }
+        else
+        {
+            designIIRStage(stage, iirStageDesigns[s].numCoefficients, iirStageDesigns[s].transitionBandwidth);
+
+            // Low-frequency group delay of the two chains (first-order allpass:
+            // (1 - a) / (1 + a) samples at the lower rate), averaged the way the
+            // half-band sums them, for up and down
+            double chainDelay[2] = { 0.0, 0.0 };
+            for (const auto& section : stage.upSections)
+                for (int chain = 0; chain < 2; ++chain)
+                    chainDelay[chain] += (1.0 - section.coeff[chain]) / (1.0 + section.coeff[chain]);
+
+            latency += (2.0 * chainDelay[0] + 1.0 + 2.0 * chainDelay[1]) * static_cast<double>(1 << (numStages - 1 - s));
+        }
+    }
+
+    if (type == LinearPhase)
+    {
+        const int topRateLatency = static_cast<int>(latency);
+        alignmentDelay = (factor - topRateLatency % factor) % factor;
+        latencySamples = (topRateLatency + alignmentDelay) / factor;
+    }
+    else
+    {
+        alignmentDelay = 0;
+        latencySamples = juce::roundToInt(latency / factor);
+    }
+
+    alignmentBuffer.setSize(2, juce::jmax(1, alignmentDelay));
+    reset();
+}
+
+void Oversampler::reset()
+{
+    for (auto& stage : stages)
+        stage.reset();
+
+    alignmentBuffer.clear();
+    alignmentPosition = 0;
+}
+
+void Oversampler::designFIRStage(Stage& stage, int halfLength, double attenuationDb, int maxInputSamples)
+{
+    // Half-band of length 4K + 3 centred on tap 2K + 1: apart from the centre
+    // (0.5), only taps an odd distance from it are non-zero. Those 2K + 2 taps
+    // form the filtered phase; the centre tap makes the other phase a delay of
+    // K samples at the lower rate.
+    const int centre = 2 * halfLength + 1;
+    const int numTaps = 2 * halfLength + 2;
+    const double beta = attenuationDb > 50.0 ? 0.1102 * (attenuationDb - 8.7)
+                                             : 0.5842 * std::pow(attenuationDb - 21.0, 0.4) + 0.07886 * (attenuationDb - 21.0);
+
+    std::vector<double> taps((size_t) numTaps);
+    double sum = 0.0;
+
+    for (int i = 0; i < numTaps; ++i)
+    {
+        const double offset = static_cast<double>(2 * i - centre);
+        const double sinc = std::sin(juce::MathConstants<double>::halfPi * offset) / (juce::MathConstants<double>::pi * offset);
+        const double ratio = offset / static_cast<double>(centre + 1);
+        taps[(size_t) i] = sinc * besselI0(beta * std::sqrt(1.0 - ratio * ratio)) / besselI0(beta);
+        sum += taps[(size_t) i];
+    }
+
+    // Unity gain at DC: the filtered phase sums to 0.5, like the centre tap.
+    // Upsampling doubles both to make up for the inserted zeros.
+    stage.upTaps.resize((size_t) numTaps);
+    stage.downTaps.resize((size_t) numTaps);
+
+    for (int i = 0; i < numTaps; ++i)
+    {
+        stage.downTaps[(size_t) i] = static_cast<float>(taps[(size_t) i] * 0.5 / sum);
+        stage.upTaps[(size_t) i] = static_cast<float>(taps[(size_t) i] / sum);
+    }
+
+    stage.halfDelay = halfLength;
+
+    stage.upWork.setSize(2, numTaps - 1 + maxInputSamples);
+    stage.downEvenWork.setSize(2, numTaps - 1 + maxInputSamples);
+    stage.downOddWork.setSize(2, halfLength + 1 + maxInputSamples);
+}
+
+void Oversampler::designIIRStage(Stage& stage, int numCoefficients, double transitionBandwidth)
+{
+    // Elliptic half-band as two parallel chains of allpasses in z^-2
+    // (Valenzuela & Constantinides), coefficients in closed form
+    const double pi = juce::MathConstants<double>::pi;
+    const int order = numCoefficients * 2 + 1;
+
+    double k = std::tan((1.0 - transitionBandwidth * 2.0) * pi / 4.0);
+    k *= k;
+    const double kkSqrt = std::pow(1.0 - k * k, 0.25);
+    const double e = 0.5 * (1.0 - kkSqrt) / (1.0 + kkSqrt);
+    const double e4 = std::pow(e, 4.0);
+    const double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+    std::vector<double> coefficients((size_t) numCoefficients);
+
+    for (int index = 0; index < numCoefficients; ++index)
+    {
+        const double c = static_cast<double>(index + 1);
+
+        double numerator = 0.0, term = 0.0, sign = 1.0;
+        for (int i = 0; i == 0 || std::abs(term) > 1.0e-100; ++i, sign = -sign)
+        {
+            term = std::pow(q, static_cast<double>(i * (i + 1))) * std::sin((i * 2 + 1) * c * pi / order) * sign;
+            numerator += term;
+        }
+
+        double denominator = 0.0;
+        sign = -1.0;
+        for (int i = 1; i == 1 || std::abs(term) > 1.0e-100; ++i, sign = -sign)
+        {
+            term = std::pow(q, static_cast<double>(i * i)) * std::cos(i * 2 * c * pi / order) * sign;
+            denominator += term;
+        }
+
+        const double ww = numerator * std::pow(q, 0.25) / (denominator + 0.5);
+        const double wwSquared = ww * ww;
+        const double x = std::sqrt((1.0 - wwSquared * k) * (1.0 - wwSquared / k)) / (1.0 + wwSquared);
+        coefficients[(size_t) index] = (1.0 - x) / (1.0 + x);
+    }
+
+    // Even coefficients make up chain 0, odd ones chain 1. Upsampling feeds
+    // chain 0 from lanes 0 and 2, downsampling feeds it from lanes 1 and 3.
+    jassert(numCoefficients % 2 == 0);
+    stage.upSections.assign((size_t) numCoefficients / 2, {});
+    stage.downSections.assign((size_t) numCoefficients / 2, {});
+
+    for (int index = 0; index < numCoefficients; ++index)
+    {
+        const float coefficient = static_cast<float>(coefficients[(size_t) index]);
+        const int chain = index % 2;
+
+        auto& up = stage.upSections[(size_t) index / 2];
+        up.coeff[chain] = up.coeff[chain + 2] = coefficient;
+
+        auto& down = stage.downSections[(size_t) index / 2];
+        down.coeff[1 - chain] = down.coeff[3 - chain] = coefficient;
+    }
+}
+
+//==============================================================================
+void Oversampler::upsample(const float* leftChannel, const float* rightChannel, int numSamples)
+{
+    jassert(numSamples <= maxBlockSize);
+    const float* input[2] = { leftChannel, rightChannel };
+
+    for (size_t s = 0; s < stages.size(); ++s)
+    {
+        auto& output = rateBuffers[s + 1];
+
+        if (filterType == LinearPhase)
+        {
+            for (int channel = 0; channel < (rightChannel != nullptr ? 2 : 1); ++channel)
+                upsampleFIR(stages[s], channel, input[channel], output.getWritePointer(channel), numSamples);
+        }
+        else
+        {
+            upsampleIIR(stages[s], input[0], rightChannel != nullptr ? input[1] : input[0],
+                        output.getWritePointer(0), rightChannel != nullptr ? output.getWritePointer(1) : nullptr, numSamples);
+        }
+
+        input[0] = output.getReadPointer(0);
+        input[1] = output.getReadPointer(1);
+        numSamples *= 2;
+    }
+}
+
+void Oversampler::downsample(float* leftChannel, float* rightChannel, int numSamples)
+{
+    jassert(numSamples <= maxBlockSize);
+    const int numChannels = rightChannel != nullptr ? 2 : 1;
+    const int numStages = static_cast<int>(stages.size());
+
+    if (alignmentDelay > 0)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            delayForAlignment(getOversampledChannel(channel), channel, numSamples << numStages);
+
+        alignmentPosition = ((numSamples << numStages) + alignmentPosition) % alignmentDelay;
+    }
+
+    for (int s = numStages - 1; s >= 0; --s)
+    {
+        const auto& input = rateBuffers[(size_t) s + 1];
+        float* output[2] = { leftChannel, rightChannel };
+
+        if (s > 0)
+        {
+            output[0] = rateBuffers[(size_t) s].getWritePointer(0);
+            output[1] = rightChannel != nullptr ? rateBuffers[(size_t) s].getWritePointer(1) : nullptr;
+        }
+
+        const int numOutputSamples = numSamples << s;
+        Stage& stage = stages[(size_t) s];
+
+        if (filterType == LinearPhase)
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+                downsampleFIR(stage, channel, input.getReadPointer(channel), output[channel], numOutputSamples);
+        }
+        else
+        {
+            downsampleIIR(stage, input.getReadPointer(0), input.getReadPointer(numChannels - 1),
+                          output[0], output[1], numOutputSamples);
+        }
+    }
+}
+
+void Oversampler::delayForAlignment(float* samples, int channel, int numSamples)
+{
+    float* ring = alignmentBuffer.getWritePointer(channel);
+    int position = alignmentPosition;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float delayed = ring[position];
+        ring[position] = samples[i];
+        samples[i] = delayed;
+
+        if (++position == alignmentDelay)
+            position = 0;
+    }
+}
+
+//==============================================================================
+void Oversampler::filterSymmetric(const float* taps, int numTaps, const float* input, float* output, int numSamples)
+{
+    // output[i] = sum of taps[k] * input[i + k], folded around the centre of
+    // the (symmetric) taps. Sixteen outputs at a time in four independent
+    // sums, so the loop isn't bound by the latency of one running sum; every
+    // output gets the same sequence of operations on each path.
+    const int numPairs = numTaps / 2;
+    const int last = numTaps - 1;
+    int i = 0;
+
+   #if VOXPROC_SIMD_SSE
+    for (; i + 16 <= numSamples; i += 16)
+    {
+        __m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps(), sum2 = _mm_setzero_ps(), sum3 = _mm_setzero_ps();
+
+        for (int k = 0; k < numPairs; ++k)
+        {
+            const __m128 tap = _mm_set1_ps(taps[k]);
+            const float* a = input + i + k;
+            const float* b = input + i + last - k;
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(tap, _mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b))));
+            sum1 = _mm_add_ps(sum1, _mm_mul_ps(tap, _mm_add_ps(_mm_loadu_ps(a + 4), _mm_loadu_ps(b + 4))));
+            sum2 = _mm_add_ps(sum2, _mm_mul_ps(tap, _mm_add_ps(_mm_loadu_ps(a + 8), _mm_loadu_ps(b + 8))));
+            sum3 = _mm_add_ps(sum3, _mm_mul_ps(tap, _mm_add_ps(_mm_loadu_ps(a + 12), _mm_loadu_ps(b + 12))));
+        }
+
+        _mm_storeu_ps(output + i, sum0);
+        _mm_storeu_ps(output + i + 4, sum1);
+        _mm_storeu_ps(output + i + 8, sum2);
+        _mm_storeu_ps(output + i + 12, sum3);
+    }
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        __m128 sum = _mm_setzero_ps();
+
+        for (int k = 0; k < numPairs; ++k)
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(taps[k]),
+                                             _mm_add_ps(_mm_loadu_ps(input + i + k), _mm_loadu_ps(input + i + last - k))));
+
+        _mm_storeu_ps(output + i, sum);
+    }
+   #elif VOXPROC_SIMD_NEON
+    for (; i + 16 <= numSamples; i += 16)
+    {
+        float32x4_t sum0 = vdupq_n_f32(0.0f), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+
+        for (int k = 0; k < numPairs; ++k)
+        {
+            const float tap = taps[k];
+            const float* a = input + i + k;
+            const float* b = input + i + last - k;
+            sum0 = vaddq_f32(sum0, vmulq_n_f32(vaddq_f32(vld1q_f32(a), vld1q_f32(b)), tap));
+            sum1 = vaddq_f32(sum1, vmulq_n_f32(vaddq_f32(vld1q_f32(a + 4), vld1q_f32(b + 4)), tap));
+            sum2 = vaddq_f32(sum2, vmulq_n_f32(vaddq_f32(vld1q_f32(a + 8), vld1q_f32(b + 8)), tap));
+            sum3 = vaddq_f32(sum3, vmulq_n_f32(vaddq_f32(vld1q_f32(a + 12), vld1q_f32(b + 12)), tap));
+        }
+
+        vst1q_f32(output + i, sum0);
+        vst1q_f32(output + i + 4, sum1);
+        vst1q_f32(output + i + 8, sum2);
+        vst1q_f32(output + i + 12, sum3);
+    }
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        float32x4_t sum = vdupq_n_f32(0.0f);
+
+        for (int k = 0; k < numPairs; ++k)
+            sum = vaddq_f32(sum, vmulq_n_f32(vaddq_f32(vld1q_f32(input + i + k), vld1q_f32(input + i + last - k)), taps[k]));
+
+        vst1q_f32(output + i, sum);
+    }
+   #endif
+
+    for (; i < numSamples; ++i)
+    {
+        float sum = 0.0f;
+
+        for (int k = 0; k < numPairs; ++k)
+            sum += taps[k] * (input[i + k] + input[i + last - k]);
+
+        output[i] = sum;
+    }
+}
+
+void Oversampler::upsampleFIR(Stage& stage, int channel, const float* input, float* output, int numSamples)
+{
+    // Even outputs: the filtered phase over the input history. Odd outputs:
+    // the input delayed by K samples.
+    const int numTaps = static_cast<int>(stage.upTaps.size());
+    const int history = numTaps - 1;
+    const int delayOffset = history - stage.halfDelay;
+
+    float* work = stage.upWork.getWritePointer(channel);
+    std::copy(input, input + numSamples, work + history);
+
+    // Filter into the upper half of the output, then interleave forwards:
+    // output[2i] and output[2i + 1] never overwrite a filtered sample that
+    // hasn't been moved yet
+    float* filtered = output + numSamples;
+    filterSymmetric(stage.upTaps.data(), numTaps, work, filtered, numSamples);
+
+    int i = 0;
+
+   #if VOXPROC_SIMD_SSE
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const __m128 even = _mm_loadu_ps(filtered + i), odd = _mm_loadu_ps(work + i + delayOffset);
+        _mm_storeu_ps(output + 2 * i, _mm_unpacklo_ps(even, odd));
+        _mm_storeu_ps(output + 2 * i + 4, _mm_unpackhi_ps(even, odd));
+    }
+   #elif VOXPROC_SIMD_NEON
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const float32x4x2_t interleaved = { { vld1q_f32(filtered + i), vld1q_f32(work + i + delayOffset) } };
+        vst2q_f32(output + 2 * i, interleaved);
+    }
+   #endif
+
+    for (; i < numSamples; ++i)
+    {
+        output[2 * i] = filtered[i];
+        output[2 * i + 1] = work[i + delayOffset];
+    }
+
+    std::copy(work + numSamples, work + numSamples + history, work);
+}
+
+void Oversampler::downsampleFIR(Stage& stage, int channel, const float* input, float* output, int numSamples)
+{
+    // Filtered phase over the even inputs plus half the odd inputs delayed by
+    // K + 1 samples (the centre tap)
+    const int numTaps = static_cast<int>(stage.downTaps.size());
+    const int evenHistory = numTaps - 1;
+    const int oddHistory = stage.halfDelay + 1;
+
+    float* even = stage.downEvenWork.getWritePointer(channel) + evenHistory;
+    float* odd = stage.downOddWork.getWritePointer(channel) + oddHistory;
+    int i = 0;
+
+   #if VOXPROC_SIMD_SSE
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const __m128 first = _mm_loadu_ps(input + 2 * i), second = _mm_loadu_ps(input + 2 * i + 4);
+        _mm_storeu_ps(even + i, _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(odd + i, _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+   #elif VOXPROC_SIMD_NEON
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const float32x4x2_t split = vld2q_f32(input + 2 * i);
+        vst1q_f32(even + i, split.val[0]);
+        vst1q_f32(odd + i, split.val[1]);
+    }
+   #endif
+
+    for (; i < numSamples; ++i)
+    {
+        even[i] = input[2 * i];
+        odd[i] = input[2 * i + 1];
+    }
+
+    even -= evenHistory;
+    odd -= oddHistory;
+
+    filterSymmetric(stage.downTaps.data(), numTaps, even, output, numSamples);
+    juce::FloatVectorOperations::addWithMultiply(output, odd, 0.5f, numSamples);
+
+    std::copy(even + numSamples, even + numSamples + evenHistory, even);
+    std::copy(odd + numSamples, odd + numSamples + oddHistory, odd);
+}
+
+//==============================================================================
+namespace
+{
+    // First-order allpass per lane, y = a * (x - y[-1]) + x[-1], through
+    // every section of a chain (Sections: a Stage's section list)
+   #if VOXPROC_SIMD_SSE
+    template <typename Sections>
+    __m128 processAllpassChains(Sections& sections, __m128 value)
+    {
+        for (auto& section : sections)
+        {
+            const __m128 output = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(value, _mm_load_ps(section.y)), _mm_load_ps(section.coeff)),
+                                             _mm_load_ps(section.x));
+            _mm_store_ps(section.x, value);
+            _mm_store_ps(section.y, output);
+            value = output;
+        }
+
+        return value;
+    }
+   #elif VOXPROC_SIMD_NEON
+    template <typename Sections>
+    float32x4_t processAllpassChains(Sections& sections, float32x4_t value)
+    {
+        for (auto& section : sections)
+        {
+            const float32x4_t output = vaddq_f32(vmulq_f32(vsubq_f32(value, vld1q_f32(section.y)), vld1q_f32(section.coeff)),
+                                                 vld1q_f32(section.x));
+            vst1q_f32(section.x, value);
+            vst1q_f32(section.y, output);
+            value = output;
+        }
+
+        return value;
+    }
+   #else
+    template <typename Sections>
+    void processAllpassChains(Sections& sections, float* lanes)
+    {
+        for (auto& section : sections)
+        {
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                const float output = (lanes[lane] - section.y[lane]) * section.coeff[lane] + section.x[lane];
+                section.x[lane] = lanes[lane];
+                section.y[lane] = output;
+                lanes[lane] = output;
+            }
+        }
+    }
+   #endif
+}
+
+void Oversampler::upsampleIIR(Stage& stage, const float* inputL, const float* inputR,
+                              float* outputL, float* outputR, int numSamples)
+{
+    // Each input sample runs through both chains of both channels at once
+    // (lanes: left chain 0, left chain 1, right chain 0, right chain 1). Chain
+    // 0 gives the even output, chain 1 the odd one.
+    for (int i = 0; i < numSamples; ++i)
+    {
+       #if VOXPROC_SIMD_SSE
+        const __m128 value = processAllpassChains(stage.upSections, _mm_setr_ps(inputL[i], inputL[i], inputR[i], inputR[i]));
+        _mm_storel_pi(reinterpret_cast<__m64*>(outputL + 2 * i), value);
+
+        if (outputR != nullptr)
+            _mm_storeh_pi(reinterpret_cast<__m64*>(outputR + 2 * i), value);
+       #elif VOXPROC_SIMD_NEON
+        const float lanes[4] = { inputL[i], inputL[i], inputR[i], inputR[i] };
+        const float32x4_t value = processAllpassChains(stage.upSections, vld1q_f32(lanes));
+        vst1_f32(outputL + 2 * i, vget_low_f32(value));
+
+        if (outputR != nullptr)
+            vst1_f32(outputR + 2 * i, vget_high_f32(value));
+       #else
+        float lanes[4] = { inputL[i], inputL[i], inputR[i], inputR[i] };
+        processAllpassChains(stage.upSections, lanes);
+        outputL[2 * i] = lanes[0];
+        outputL[2 * i + 1] = lanes[1];
+
+        if (outputR != nullptr)
+        {
+            outputR[2 * i] = lanes[2];
+            outputR[2 * i + 1] = lanes[3];
+        }
+       #endif
+    }
+}
+
+void Oversampler::downsampleIIR(Stage& stage, const float* inputL, const float* inputR,
+                                float* outputL, float* outputR, int numSamples)
+{
+    // Input pairs as they come (lanes: left even, left odd, right even, right
+    // odd); the down sections carry chain 1's coefficients in the even lanes
+    // and chain 0's in the odd ones. The output is the average of each pair.
+    for (int i = 0; i < numSamples; ++i)
+    {
+       #if VOXPROC_SIMD_SSE
+        __m128 value = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(inputL + 2 * i));
+        value = _mm_loadh_pi(value, reinterpret_cast<const __m64*>(inputR + 2 * i));
+        value = processAllpassChains(stage.downSections, value);
+        value = _mm_mul_ps(_mm_set1_ps(0.5f), _mm_add_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1))));
+
+        _mm_store_ss(outputL + i, value);
+
+        if (outputR != nullptr)
+            _mm_store_ss(outputR + i, _mm_movehl_ps(value, value));
+       #elif VOXPROC_SIMD_NEON
+        float32x4_t value = vcombine_f32(vld1_f32(inputL + 2 * i), vld1_f32(inputR + 2 * i));
+        value = processAllpassChains(stage.downSections, value);
+        const float32x2_t sums = vpadd_f32(vget_low_f32(value), vget_high_f32(value));
+
+        outputL[i] = 0.5f * vget_lane_f32(sums, 0);
+
+        if (outputR != nullptr)
+            outputR[i] = 0.5f * vget_lane_f32(sums, 1);
+       #else
+        float lanes[4] = { inputL[2 * i], inputL[2 * i + 1], inputR[2 * i], inputR[2 * i + 1] };
+        processAllpassChains(stage.downSections, lanes);
+        outputL[i] = 0.5f * (lanes[0] + lanes[1]);
+
+        if (outputR != nullptr)
+            outputR[i] = 0.5f * (lanes[2] + lanes[3]);
+       #endif
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSPUtils.h"
+
+// 2x/4x/8x oversampling as a cascade of 2x half-band stages, for running the
+// nonlinear modules above the base rate. Each stage is polyphase: the filter
+// is split into its even and odd phases so it runs at the lower of its two
+// rates and never touches the zeros the rate change would insert.
+//
+//  - LinearPhase: half-band FIRs (Kaiser windowed). Every other tap of a
+//    half-band is zero, so one phase is a plain delay and only the other is
+//    filtered. The latency is padded to a whole number of base-rate samples.
+//  - MinimumPhase: half-band polyphase allpass IIRs (two chains of first-order
+//    allpasses at the lower rate). Far shorter delay, with nonlinear phase near
+//    the top of the band. The reported latency is the low-frequency delay.
+class Oversampler
+{
+public:
+    enum FilterType
+    {
+        LinearPhase = 0,
+        MinimumPhase
+    };
+
+    static constexpr int maxFactorLog2 = 3;  // 8x
+
+    // Designs the stages and allocates for blocks of up to maxSamplesPerBlock
+    // base-rate samples. factorLog2 = 0 passes the audio straight through.
+    // Not real-time safe.
+    void prepare(int factorLog2, FilterType type, int maxSamplesPerBlock);
+    void reset();
+
+    int getFactor() const { return 1 << static_cast<int>(stages.size()); }
+    int getMaxBlockSize() const { return maxBlockSize; }
+    FilterType getFilterType() const { return filterType; }
+
+    // Delay of upsample() followed by downsample(), in base-rate samples
+    int getLatencySamples() const { return latencySamples; }
+
+    // Upsamples numSamples (at most getMaxBlockSize()) base-rate samples into
+    // the oversampled buffer, numSamples * getFactor() long. rightChannel may
+    // be null for mono.
+    void upsample(const float* leftChannel, const float* rightChannel, int numSamples);
+    float* getOversampledChannel(int channel) { return rateBuffers[stages.size()].getWritePointer(channel); }
+
+    // Filters the oversampled buffer back down into numSamples base-rate samples
+    void downsample(float* leftChannel, float* rightChannel, int numSamples);
+
+private:
+    // One 2x stage, upsampling from and downsampling to its lower rate
+    struct Stage
+    {
+        // FIR: the filtered phase's taps (symmetric), the plain phase's delay
+        // and, per channel, input history followed by room for one block
+        std::vector<float> upTaps, downTaps;
+        int halfDelay = 0;
+        juce::AudioBuffer<float> upWork, downEvenWork, downOddWork;
+
+        // IIR: allpass coefficients per section, for the two chains
+        // interleaved with the two channels (lanes: chain 0 and 1 of the left
+        // channel, then of the right), and the section states
+        struct Section
+        {
+            alignas(16) float coeff[4] {};
+            alignas(16) float x[4] {};
+            alignas(16) float y[4] {};
+        };
+
+        std::vector<Section> upSections, downSections;
+
+        void reset();
+    };
+
+    static void designFIRStage(Stage& stage, int halfLength, double attenuationDb, int maxInputSamples);
+    static void designIIRStage(Stage& stage, int numCoefficients, double transitionBandwidth);
+
+    static void filterSymmetric(const float* taps, int numTaps, const float* input, float* output, int numSamples);
+    static void upsampleFIR(Stage& stage, int channel, const float* input, float* output, int numSamples);
+    static void downsampleFIR(Stage& stage, int channel, const float* input, float* output, int numSamples);
+    static void upsampleIIR(Stage& stage, const float* inputL, const float* inputR, float* outputL, float* outputR, int numSamples);
+    static void downsampleIIR(Stage& stage, const float* inputL, const float* inputR, float* outputL, float* outputR, int numSamples);
+
+    void delayForAlignment(float* samples, int channel, int numSamples);
+
+    FilterType filterType = LinearPhase;
+    std::vector<Stage> stages;
+
+    // Signal at each rate: index s holds the output of stage s - 1 (the base
+    // rate, index 0, is the caller's buffer)
+    std::vector<juce::AudioBuffer<float>> rateBuffers;
+    int maxBlockSize = 0;
+    int latencySamples = 0;
+
+    // Linear phase: extra delay at the top rate that rounds the latency up to
+    // whole base-rate samples
+    int alignmentDelay = 0;
+    juce::AudioBuffer<float> alignmentBuffer { 2, 1 };
+    int alignmentPosition = 0;
+};
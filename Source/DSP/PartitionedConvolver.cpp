@@ -0,0 +1,351 @@
+#include "PartitionedConvolver.h"
+
+void PartitionedConvolver::Filter::design(const float* impulse, int numTaps, int newPartitionSize, juce::dsp::FFT& fft)
+{
+    jassert(fft.getSize() == 2 * newPartitionSize);
+
+    partitionSize = newPartitionSize;
+    numPartitions = juce::jmax(1, (numTaps + partitionSize - 1) / partitionSize);
+
+    const int spectrumSize = getSpectrumSize(partitionSize);
+    spectra.assign((size_t) (numPartitions * spectrumSize), 0.0f);
+
+    // Each partition zero-padded to the FFT size
+    std::vector<float> data((size_t) (4 * partitionSize));
+
+    for (int p = 0; p < numPartitions; ++p)
+    {
+        const int start = p * partitionSize;
+        const int num = juce::jmax(0, juce::jmin(partitionSize, numTaps - start));
+
+        std::fill(data.begin(), data.end(), 0.0f);
+        std::copy(impulse + start, impulse + start + num, data.begin());
+        fft.performRealOnlyForwardTransform(data.data(), true);
+
+        deinterleave(data.data(), spectra.data() + (size_t) (p * spectrumSize), partitionSize);
+    }
+}
+
+void PartitionedConvolver::prepare(int newPartitionSize, int maxTaps)
+{
+    jassert(juce::isPowerOfTwo(newPartitionSize));
+
+    partitionSize = newPartitionSize;
+    maxPartitions = juce::jmax(1, (maxTaps + partitionSize - 1) / partitionSize);
+    fft = std::make_unique<juce::dsp::FFT>(juce::roundToInt(std::log2(2 * partitionSize)));
+
+    const size_t spectrumSize = (size_t) getSpectrumSize(partitionSize);
+
+    for (auto& slot : slots)
+    {
+        slot.numPartitions = 0;
+        slot.spectra.assign(spectrumSize * (size_t) maxPartitions, 0.0f);
+    }
+
+    for (auto& channel : channels)
+    {
+        channel.window.assign((size_t) (2 * partitionSize), 0.0f);
+        channel.inputSpectra.assign(spectrumSize * (size_t) maxPartitions, 0.0f);
+
+        for (auto& sum : channel.tailSums)
+            sum.assign(spectrumSize, 0.0f);
+    }
+
+    work.setSize(2, 4 * partitionSize);
+
+    currentSlot = -1;
+    incomingSlot = -1;
+    reset();
+}
+
+void PartitionedConvolver::reset()
+{
+    for (auto& channel : channels)
+    {
+        std::fill(channel.window.begin(), channel.window.end(), 0.0f);
+        std::fill(channel.inputSpectra.begin(), channel.inputSpectra.end(), 0.0f);
+
+        for (auto& sum : channel.tailSums)
+            std::fill(sum.begin(), sum.end(), 0.0f);
+    }
+
+    newestPartition = 0;
+    partitionPosition = 0;
+
+    // No signal to fade: a filter on its way in takes over now
+    if (incomingSlot >= 0)
+        currentSlot = incomingSlot;
+
+    incomingSlot = -1;
+    fadeSamplesRemaining = 0;
+}
+
+bool PartitionedConvolver::loadFilter(const Filter& filter, int fadePartitions)
+{
+    if (isLoadingFilter())
+        return false;
+
+    jassert(filter.partitionSize == partitionSize && filter.numPartitions <= maxPartitions);
+
+    const int slotIndex = currentSlot == 0 ? 1 : 0;
+    Slot& slot = slots[(size_t) slotIndex];
+    slot.numPartitions = juce::jmin(filter.numPartitions, maxPartitions);
+    std::copy(filter.spectra.begin(), filter.spectra.begin() + slot.numPartitions * getSpectrumSize(partitionSize),
+              slot.spectra.begin());
+
+    if (currentSlot < 0 || fadePartitions <= 0)
+    {
+        // Mid-partition the tail sums for the new filter are needed right away
+        currentSlot = slotIndex;
+
+        for (int channel = 0; channel < 2; ++channel)
+            sumTail(channel, currentSlot);
+
+        return true;
+    }
+
+    incomingSlot = slotIndex;
+    fadeSamples = fadePartitions * partitionSize;
+    return true;
+}
+
+void PartitionedConvolver::process(float* leftChannel, float* rightChannel, int numSamples)
+{
+    const int numChannels = rightChannel != nullptr ? 2 : 1;
+
+    for (int start = 0; start < numSamples;)
+    {
+        if (partitionPosition == 0)
+        {
+            // A pending filter starts fading in at the partition boundary
+            if (incomingSlot >= 0 && fadeSamplesRemaining == 0)
+                fadeSamplesRemaining = fadeSamples;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                if (currentSlot >= 0)         sumTail(channel, currentSlot);
+                if (fadeSamplesRemaining > 0) sumTail(channel, incomingSlot);
+            }
+        }
+
+        const int num = juce::jmin(numSamples - start, partitionSize - partitionPosition);
+
+        processPartition(0, leftChannel + start, num);
+        if (numChannels > 1)
+            processPartition(1, rightChannel + start, num);
+
+        if (fadeSamplesRemaining > 0)
+        {
+            fadeSamplesRemaining -= num;
+
+            if (fadeSamplesRemaining == 0)
+            {
+                currentSlot = incomingSlot;
+                incomingSlot = -1;
+            }
+        }
+
+        partitionPosition += num;
+        start += num;
+
+        if (partitionPosition == partitionSize)
+        {
+            // The current partition becomes the previous one in the window
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                float* window = channels[(size_t) channel].window.data();
+                std::copy(window + partitionSize, window + 2 * partitionSize, window);
+                std::fill(window + partitionSize, window + 2 * partitionSize, 0.0f);
+            }
+
+            newestPartition = (newestPartition + 1) % maxPartitions;
+            partitionPosition = 0;
+        }
+    }
+}
+
+void PartitionedConvolver::sumTail(int channel, int slotIndex)
+{
+    // Every filter partition but the first, against the input partitions
+    // that are already complete
+    const Slot& slot = slots[(size_t) slotIndex];
+    const Channel& c = channels[(size_t) channel];
+    const int spectrumSize = getSpectrumSize(partitionSize);
+
+    float* sum = channels[(size_t) channel].tailSums[(size_t) slotIndex].data();
+    std::fill(sum, sum + spectrumSize, 0.0f);
+
+    int inputPartition = newestPartition;
+
+    for (int p = 1; p < slot.numPartitions; ++p)
+    {
+        inputPartition = inputPartition > 0 ? inputPartition - 1 : maxPartitions - 1;
+        multiplyAccumulate(c.inputSpectra.data() + (size_t) (inputPartition * spectrumSize),
+                           slot.spectra.data() + (size_t) (p * spectrumSize), sum, partitionSize);
+    }
+}
+
+void PartitionedConvolver::processPartition(int channel, float* samples, int numSamples)
+{
+    Channel& c = channels[(size_t) channel];
+    const int spectrumSize = getSpectrumSize(partitionSize);
+    float* window = c.window.data();
+
+    std::copy(samples, samples + numSamples, window + partitionSize + partitionPosition);
+
+    // Spectrum of the window so far (the rest of the current partition is
+    // still zero), into the delay line
+    float* data = work.getWritePointer(0);
+    std::copy(window, window + 2 * partitionSize, data);
+    fft->performRealOnlyForwardTransform(data, true);
+
+    float* input = c.inputSpectra.data() + (size_t) (newestPartition * spectrumSize);
+    deinterleave(data, input, partitionSize);
+
+    if (currentSlot < 0)
+    {
+        std::fill(samples, samples + numSamples, 0.0f);
+        return;
+    }
+
+    // Overlap-save: the second half of the window is the valid output
+    const float* output = convolve(channel, currentSlot, work.getWritePointer(0));
+
+    if (fadeSamplesRemaining == 0)
+    {
+        std::copy(output, output + numSamples, samples);
+        return;
+    }
+
+    // Crossfade to the incoming filter
+    const float* incoming = convolve(channel, incomingSlot, work.getWritePointer(1));
+    const float step = 1.0f / static_cast<float>(fadeSamples);
+    const float startGain = static_cast<float>(fadeSamples - fadeSamplesRemaining) * step;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float gain = startGain + static_cast<float>(i + 1) * step;
+        samples[i] = output[i] + gain * (incoming[i] - output[i]);
+    }
+}
+
+const float* PartitionedConvolver::convolve(int channel, int slotIndex, float* data)
+{
+    const Channel& c = channels[(size_t) channel];
+    const float* input = c.inputSpectra.data() + (size_t) (newestPartition * getSpectrumSize(partitionSize));
+
+    multiplyAdd(input, slots[(size_t) slotIndex].spectra.data(), c.tailSums[(size_t) slotIndex].data(), data, partitionSize);
+    fft->performRealOnlyInverseTransform(data);
+
+    return data + partitionSize + partitionPosition;
+}
+
+void PartitionedConvolver::multiplyAdd(const float* x, const float* h, const float* sum, float* out, int numBins)
+{
+    // numBins + 1 bins (DC to Nyquist); numBins is a multiple of 4
+    const float* xr = x;
+    const float* xi = x + numBins + 1;
+    const float* hr = h;
+    const float* hi = h + numBins + 1;
+    const float* sr = sum;
+    const float* si = sum + numBins + 1;
+    int k = 0;
+
+   #if VOXPROC_SIMD_SSE
+    for (; k + 4 <= numBins; k += 4)
+    {
+        const __m128 ar = _mm_loadu_ps(xr + k), ai = _mm_loadu_ps(xi + k);
+        const __m128 br = _mm_loadu_ps(hr + k), bi = _mm_loadu_ps(hi + k);
+
+        const __m128 re = _mm_add_ps(_mm_loadu_ps(sr + k), _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi)));
+        const __m128 im = _mm_add_ps(_mm_loadu_ps(si + k), _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br)));
+
+        _mm_storeu_ps(out + 2 * k, _mm_unpacklo_ps(re, im));
+        _mm_storeu_ps(out + 2 * k + 4, _mm_unpackhi_ps(re, im));
+    }
+   #elif VOXPROC_SIMD_NEON
+    for (; k + 4 <= numBins; k += 4)
+    {
+        const float32x4_t ar = vld1q_f32(xr + k), ai = vld1q_f32(xi + k);
+        const float32x4_t br = vld1q_f32(hr + k), bi = vld1q_f32(hi + k);
+
+        float32x4x2_t result;
+        result.val[0] = vmlsq_f32(vmlaq_f32(vld1q_f32(sr + k), ar, br), ai, bi);
+        result.val[1] = vmlaq_f32(vmlaq_f32(vld1q_f32(si + k), ar, bi), ai, br);
+        vst2q_f32(out + 2 * k, result);
+    }
+   #endif
+
+    for (; k <= numBins; ++k)
+    {
+        out[2 * k] = sr[k] + xr[k] * hr[k] - xi[k] * hi[k];
+        out[2 * k + 1] = si[k] + xr[k] * hi[k] + xi[k] * hr[k];
+    }
+}
+
+void PartitionedConvolver::multiplyAccumulate(const float* x, const float* h, float* sum, int numBins)
+{
+    const float* xr = x;
+    const float* xi = x + numBins + 1;
+    const float* hr = h;
+    const float* hi = h + numBins + 1;
+    float* sr = sum;
+    float* si = sum + numBins + 1;
+    int k = 0;
+
+   #if VOXPROC_SIMD_SSE
+    for (; k + 4 <= numBins; k += 4)
+    {
+        const __m128 ar = _mm_loadu_ps(xr + k), ai = _mm_loadu_ps(xi + k);
+        const __m128 br = _mm_loadu_ps(hr + k), bi = _mm_loadu_ps(hi + k);
+
+        _mm_storeu_ps(sr + k, _mm_add_ps(_mm_loadu_ps(sr + k), _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi))));
+        _mm_storeu_ps(si + k, _mm_add_ps(_mm_loadu_ps(si + k), _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br))));
+    }
+   #elif VOXPROC_SIMD_NEON
+    for (; k + 4 <= numBins; k += 4)
+    {
+        const float32x4_t ar = vld1q_f32(xr + k), ai = vld1q_f32(xi + k);
+        const float32x4_t br = vld1q_f32(hr + k), bi = vld1q_f32(hi + k);
+
+        vst1q_f32(sr + k, vmlsq_f32(vmlaq_f32(vld1q_f32(sr + k), ar, br), ai, bi));
+        vst1q_f32(si + k, vmlaq_f32(vmlaq_f32(vld1q_f32(si + k), ar, bi), ai, br));
+    }
+   #endif
+
+    for (; k <= numBins; ++k)
+    {
+        sr[k] += xr[k] * hr[k] - xi[k] * hi[k];
+        si[k] += xr[k] * hi[k] + xi[k] * hr[k];
+    }
+}
+
+void PartitionedConvolver::deinterleave(const float* interleaved, float* split, int numBins)
+{
+    float* re = split;
+    float* im = split + numBins + 1;
+    int k = 0;
+
+   #if VOXPROC_SIMD_SSE
+    for (; k + 4 <= numBins; k += 4)
+    {
+        const __m128 a = _mm_loadu_ps(interleaved + 2 * k);
+        const __m128 b = _mm_loadu_ps(interleaved + 2 * k + 4);
+        _mm_storeu_ps(re + k, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(im + k, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+   #elif VOXPROC_SIMD_NEON
+    for (; k + 4 <= numBins; k += 4)
+    {
+        const float32x4x2_t values = vld2q_f32(interleaved + 2 * k);
+        vst1q_f32(re + k, values.val[0]);
+        vst1q_f32(im + k, values.val[1]);
+    }
+   #endif
+
+    for (; k <= numBins; ++k)
+    {
+        re[k] = interleaved[2 * k];
+        im[k] = interleaved[2 * k + 1];
+    }
+}
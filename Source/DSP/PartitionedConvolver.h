@@ -0,0 +1,105 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSPUtils.h"
+
+// Stereo FIR convolution, uniformly partitioned overlap-save. The filter is
+// cut into partitions of partitionSize taps, each transformed with a
+// 2 * partitionSize FFT, and the spectra of past input partitions are kept in
+// a frequency-domain delay line. A full partition of input then costs one
+// forward FFT, one complex multiply-accumulate per filter partition and one
+// inverse FFT per channel.
+//
+// Shorter calls add no latency: the partly filled current partition is
+// transformed on every call and only its own product is redone; the older
+// partitions' sum is computed once, when a new partition starts. With calls
+// of exactly partitionSize samples every call does the same work.
+class PartitionedConvolver
+{
+public:
+    // A filter transformed for one partition size: numPartitions spectra of
+    // partitionSize + 1 bins, each stored as the real parts followed by the
+    // imaginary parts (getSpectrumSize() floats per partition)
+    struct Filter
+    {
+        int partitionSize = 0;
+        int numPartitions = 0;
+        std::vector<float> spectra;
+
+        // Transforms numTaps of impulse. fft must be of size 2 * newPartitionSize.
+        // Not real-time safe.
+        void design(const float* impulse, int numTaps, int newPartitionSize, juce::dsp::FFT& fft);
+
+        const float* getSpectrum(int partition) const
+        {
+            return spectra.data() + (size_t) partition * (size_t) getSpectrumSize(partitionSize);
+        }
+    };
+
+    static int getSpectrumSize(int partitionSize) { return 2 * (partitionSize + 1); }
+
+    // partitionSize must be a power of two; filters can have up to maxTaps
+    // taps. Not real-time safe.
+    void prepare(int partitionSize, int maxTaps);
+    void reset();
+
+    int getPartitionSize() const { return partitionSize; }
+
+    // Copies the filter in (same partition size, at most maxTaps long). It
+    // takes over at the start of the next partition, crossfaded from the
+    // current one over fadePartitions partitions; 0 switches straight away,
+    // for the first filter. Returns false without loading anything while the
+    // previous change is still pending or fading.
+    bool loadFilter(const Filter& filter, int fadePartitions);
+    bool isLoadingFilter() const { return incomingSlot >= 0; }
+    bool hasFilter() const { return currentSlot >= 0; }
+
+    // rightChannel may be null for mono. Outputs silence until a filter is loaded.
+    void process(float* leftChannel, float* rightChannel, int numSamples);
+
+private:
+    // out (interleaved, the way the FFT takes it) = sum + h * x, over the
+    // numBins + 1 bins of split-format spectra
+    static void multiplyAdd(const float* x, const float* h, const float* sum, float* out, int numBins);
+    // sum += h * x, all split format
+    static void multiplyAccumulate(const float* x, const float* h, float* sum, int numBins);
+    static void deinterleave(const float* interleaved, float* split, int numBins);
+
+    void sumTail(int channel, int slotIndex);
+    void processPartition(int channel, float* samples, int numSamples);
+    const float* convolve(int channel, int slotIndex, float* data);
+
+    int partitionSize = 0;
+    int maxPartitions = 0;
+    std::unique_ptr<juce::dsp::FFT> fft;
+
+    // Two filter slots: the current one and the one fading in
+    struct Slot
+    {
+        int numPartitions = 0;
+        std::vector<float> spectra;
+    };
+
+    std::array<Slot, 2> slots;
+    int currentSlot = -1;
+    int incomingSlot = -1;         // Loaded, fading in (or waiting for the next partition to)
+    int fadeSamples = 0;
+    int fadeSamplesRemaining = 0;  // 0 while the incoming filter waits
+
+    // Per channel: the previous and current input partition (overlap-save
+    // window), the spectra of the last maxPartitions input partitions, and
+    // per slot the sum over all but the newest one
+    struct Channel
+    {
+        std::vector<float> window;
+        std::vector<float> inputSpectra;
+        std::array<std::vector<float>, 2> tailSums;
+    };
+
+    std::array<Channel, 2> channels;
+    int newestPartition = 0;     // Delay line slot of the current input partition
+    int partitionPosition = 0;   // Samples of the current partition filled so far
+
+    // FFT in/out (2 * fft size floats) and a second output for crossfades
+    juce::AudioBuffer<float> work { 2, 1 };
+};
@@ -155,6 +155,48 @@ static void drawFootswitch(juce::Graphics& g, juce::Rectangle<float> bounds, boo
 //==============================================================================
 // LevelMeter
 //==============================================================================
+float LevelMeter::getNormalizedLevel() const
+{
+    float db = juce::Decibels::gainToDecibels(level, -60.0f);
+    float normalized = juce::jmap(db, -60.0f, 0.0f, 0.0f, 1.0f);
+    return juce::jlimit(0.0f, 1.0f, normalized);
+}
+
+void LevelMeter::updateBar()
+{
+    const float normalized = getNormalizedLevel();
+    barLength = juce::roundToInt(normalized * (float) (vertical ? getHeight() : getWidth()));
+    colourZone = normalized < 0.6f ? 0 : (normalized < 0.85f ? 1 : 2);
+}
+
+void LevelMeter::setLevel(float newLevel)
+{
+    level = newLevel;
+
+    const int oldLength = barLength;
+    const int oldZone = colourZone;
+    updateBar();
+
+    if (barLength == oldLength && colourZone == oldZone)
+        return;
+
+    if (colourZone != oldZone)
+    {
+        repaint();
+        return;
+    }
+
+    // Span between the old and new bar ends, plus the rounded corners
+    const int margin = 4;
+    const int start = juce::jmin(oldLength, barLength) - margin;
+    const int end = juce::jmax(oldLength, barLength) + margin;
+
+    if (vertical)
+        repaint(0, getHeight() - end, getWidth(), end - start);
+    else
+        repaint(start, 0, end - start, getHeight());
+}
+
 void LevelMeter::paint(juce::Graphics& g)
 {
     auto bounds = getLocalBounds().toFloat();
@@ -163,31 +205,25 @@ void LevelMeter::paint(juce::Graphics& g)
     g.setColour(juce::Colour(0xff151515));
     g.fillRoundedRectangle(bounds, 3.0f);
 
-    // Calculate level
-    float db = juce::Decibels::gainToDecibels(level, -60.0f);
-    float normalized = juce::jmap(db, -60.0f, 0.0f, 0.0f, 1.0f);
-    normalized = juce::jlimit(0.0f, 1.0f, normalized);
-
     // Gradient color
     juce::Colour barColour;
-    if (normalized < 0.6f)
+    if (colourZone == 0)
         barColour = VoxColors::meterGreen;
-    else if (normalized < 0.85f)
+    else if (colourZone == 1)
         barColour = VoxColors::meterYellow;
     else
         barColour = VoxColors::meterRed;
 
+    // Bar length in whole pixels (see setLevel)
     if (vertical)
     {
-        float barHeight = bounds.getHeight() * normalized;
-        auto barBounds = bounds.removeFromBottom(barHeight);
+        auto barBounds = bounds.removeFromBottom((float) barLength);
         g.setColour(barColour);
         g.fillRoundedRectangle(barBounds.reduced(1), 2.0f);
     }
     else
     {
-        float barWidth = bounds.getWidth() * normalized;
-        auto barBounds = bounds.removeFromLeft(barWidth);
+        auto barBounds = bounds.removeFromLeft((float) barLength);
         g.setColour(barColour);
         g.fillRoundedRectangle(barBounds.reduced(1), 2.0f);
     }
@@ -200,6 +236,38 @@ void LevelMeter::paint(juce::Graphics& g)
 //==============================================================================
 // GainReductionMeter
 //==============================================================================
+int GainReductionMeter::getLitSegments(float gainReductionDb)
+{
+    // Gain reduction is in dB (0 to ~18dB for full scale)
+    float grDb = juce::jlimit(0.0f, 18.0f, gainReductionDb);
+    return (int)((grDb / 18.0f) * numSegments);
+}
+
+juce::Rectangle<float> GainReductionMeter::getSegmentBounds(int index) const
+{
+    auto bounds = getLocalBounds().toFloat();
+    float segmentWidth = (bounds.getWidth() - 10) / numSegments;
+    float segmentHeight = bounds.getHeight() - 8;
+    float segmentGap = 2.0f;
+
+    return { bounds.getX() + 5 + index * segmentWidth, bounds.getY() + 4, segmentWidth - segmentGap, segmentHeight };
+}
+
+void GainReductionMeter::setGainReduction(float gr)
+{
+    gainReduction = gr;
+
+    const int newLitSegments = getLitSegments(gainReduction);
+    if (newLitSegments == litSegments)
+        return;
+
+    const int first = juce::jmin(litSegments, newLitSegments);
+    const int last = juce::jmax(litSegments, newLitSegments) - 1;
+    litSegments = newLitSegments;
+
+    repaint(getSegmentBounds(first).getUnion(getSegmentBounds(last)).expanded(1.0f).getSmallestIntegerContainer());
+}
+
 void GainReductionMeter::paint(juce::Graphics& g)
 {
     auto bounds = getLocalBounds().toFloat();
@@ -209,19 +277,8 @@ void GainReductionMeter::paint(juce::Graphics& g)
     g.fillRoundedRectangle(bounds, 4.0f);
 
     // Segmented LED meter
-    const int numSegments = 12;
-    float segmentWidth = (bounds.getWidth() - 10) / numSegments;
-    float segmentHeight = bounds.getHeight() - 8;
-    float segmentGap = 2.0f;
-
-    // Gain reduction is in dB (0 to ~18dB for full scale)
-    float grDb = juce::jlimit(0.0f, 18.0f, gainReduction);
-    int litSegments = (int)((grDb / 18.0f) * numSegments);
-
     for (int i = 0; i < numSegments; ++i)
     {
-        float segX = bounds.getX() + 5 + i * segmentWidth;
-
         juce::Colour segColour;
         if (i < 6)
             segColour = VoxColors::meterGreen;
@@ -232,7 +289,7 @@ void GainReductionMeter::paint(juce::Graphics& g)
 
         bool isLit = i < litSegments;
         g.setColour(isLit ? segColour : segColour.withAlpha(0.15f));
-        g.fillRoundedRectangle(segX, bounds.getY() + 4, segmentWidth - segmentGap, segmentHeight, 2.0f);
+        g.fillRoundedRectangle(getSegmentBounds(i), 2.0f);
     }
 
     // Border
@@ -258,64 +315,151 @@ float EQVisualizer::dbToY(float db, float height) const
     return height * 0.5f * (1.0f - db / 18.0f);
 }
 
-float EQVisualizer::getBandMagnitudeAtFrequency(float freq, int bandIndex) const
+void EQVisualizer::updateResponseCurves(juce::Rectangle<float> bounds)
 {
-    return processor.getEQBandMagnitudeAtFrequency(freq, bandIndex);
+    const auto& published = processor.getEQDisplayCoefficients();
+    const bool gridChanged = bounds != responseBounds || published.sampleRate != responseGrid.sampleRate;
+
+    if (! gridChanged && published.version == eqCoefficients.version)
+        return;
+
+    if (gridChanged)
+    {
+        // One point every 2 pixels, log scale from 20Hz to 20kHz
+        std::vector<float> frequencies;
+        for (float x = 0; x < bounds.getWidth(); x += 2.0f)
+            frequencies.push_back(20.0f * std::pow(1000.0f, x / bounds.getWidth()));
+
+        responseGrid.setFrequencies(frequencies.data(), (int) frequencies.size(), published.sampleRate);
+        responseBounds = bounds;
+
+        for (auto& magnitudes : bandMagnitudes)
+            magnitudes.resize(frequencies.size());
+
+        combinedMagnitudes.resize(frequencies.size());
+        curveDb.resize(frequencies.size());
+    }
+
+    bool anyBandChanged = false;
+
+    for (int band = 0; band < Equalizer::NumBands; ++band)
+    {
+        if (! gridChanged && published.hasSameBand(eqCoefficients, band))
+            continue;
+
+        published.getBandMagnitudes(responseGrid, band, bandMagnitudes[(size_t) band].data());
+        buildResponsePath(bandPaths[(size_t) band], bandMagnitudes[(size_t) band], bounds);
+        anyBandChanged = true;
+    }
+
+    if (anyBandChanged)
+    {
+        std::fill(combinedMagnitudes.begin(), combinedMagnitudes.end(), 1.0f);
+
+        for (int band = 0; band < Equalizer::NumBands; ++band)
+        {
+            if (published.isBandEnabled(band))
+                juce::FloatVectorOperations::multiply(combinedMagnitudes.data(), bandMagnitudes[(size_t) band].data(),
+                                                      (int) combinedMagnitudes.size());
+        }
+
+        buildResponsePath(responsePath, combinedMagnitudes, bounds);
+    }
+
+    eqCoefficients = published;
 }
 
-float EQVisualizer::binToFreq(int bin, double sampleRate) const
+void EQVisualizer::buildResponsePath(juce::Path& path, const std::vector<float>& magnitudes, juce::Rectangle<float> bounds)
 {
-    return (float)bin * (float)sampleRate / (float)fftSize;
+    const int numPoints = (int) magnitudes.size();
+    DSPUtils::fastLinearToDecibels(magnitudes.data(), curveDb.data(), numPoints);
+
+    path.clear();
+    path.preallocateSpace(numPoints * 3);
+
+    for (int i = 0; i < numPoints; ++i)
+    {
+        float db = juce::jlimit(-18.0f, 18.0f, curveDb[(size_t) i]);
+        float x = bounds.getX() + 2.0f * (float) i;
+        float y = bounds.getY() + dbToY(db, bounds.getHeight());
+
+        if (i == 0)
+            path.startNewSubPath(x, y);
+        else
+            path.lineTo(x, y);
+    }
 }
 
-void EQVisualizer::drawSpectrum(juce::Graphics& g, const std::array<float, fftSize / 2>& spectrum,
-                                 juce::Colour colour, float alpha, juce::Rectangle<float> bounds)
+void EQVisualizer::updateSpectrumColumns(float width, double sampleRate)
 {
-    double sampleRate = processor.getCurrentSampleRate();
-    juce::Path spectrumPath;
-    bool pathStarted = false;
+    if (width == spectrumColumnsWidth && sampleRate == spectrumColumnsSampleRate)
+        return;
 
-    // We'll draw from 20Hz to 20kHz
-    for (float x = 0; x < bounds.getWidth(); x += 1.0f)
+    spectrumColumnsWidth = width;
+    spectrumColumnsSampleRate = sampleRate;
+    spectrumColumns.resize((size_t) juce::jmax(0, (int) std::ceil(width)));
+
+    const int lastUsableBin = fftSize / 2 - 1;
+
+    // Fractional bin position of the frequency at pixel x (log scale, 20Hz to 20kHz)
+    auto binAt = [&](float x)
     {
-        // Convert x position to frequency (logarithmic scale)
-        float freq = 20.0f * std::pow(1000.0f, x / bounds.getWidth());
+        return 20.0f * std::pow(1000.0f, x / width) * (float) fftSize / (float) sampleRate;
+    };
 
-        // Find the FFT bin for this frequency
-        int bin = (int)(freq * fftSize / sampleRate);
-        if (bin < 0) bin = 0;
-        if (bin >= fftSize / 2) bin = fftSize / 2 - 1;
+    for (size_t column = 0; column < spectrumColumns.size(); ++column)
+    {
+        const float low = binAt((float) column);
+        const float high = binAt((float) column + 1.0f);
+        auto& c = spectrumColumns[column];
 
-        // Get magnitude and convert to dB
-        float magnitude = spectrum[bin];
+        // Bins centred inside the column
+        c.firstBin = juce::jlimit(0, lastUsableBin, (int) std::ceil(low));
+        c.lastBin = juce::jlimit(0, lastUsableBin, (int) std::floor(high));
 
-        // Interpolate between bins for smoother display
-        if (bin > 0 && bin < fftSize / 2 - 1)
+        if (c.lastBin < c.firstBin)
         {
-            float frac = (freq * fftSize / sampleRate) - bin;
-            magnitude = spectrum[bin] * (1.0f - frac) + spectrum[bin + 1] * frac;
+            // Narrower than a bin: interpolate at the column's left edge
+            c.firstBin = juce::jlimit(0, lastUsableBin - 1, (int) low);
+            c.lastBin = c.firstBin - 1;
+            c.fraction = juce::jlimit(0.0f, 1.0f, low - (float) c.firstBin);
         }
+    }
+}
+
+void EQVisualizer::drawSpectrum(juce::Graphics& g, const std::array<float, fftSize / 2>& spectrumDb,
+                                 juce::Colour colour, float alpha, juce::Rectangle<float> bounds)
+{
+    // Boost magnitude to make display more sensitive (20x boost = +26dB)
+    const float boostDb = 26.0206f;
+
+    updateSpectrumColumns(bounds.getWidth(), processor.getCurrentSampleRate());
+
+    juce::Path spectrumPath;
+    spectrumPath.preallocateSpace((int) spectrumColumns.size() * 3 + 8);
+
+    for (size_t column = 0; column < spectrumColumns.size(); ++column)
+    {
+        const auto& c = spectrumColumns[column];
 
-        // Boost magnitude to make display more sensitive (20x boost = +26dB)
-        magnitude *= 20.0f;
+        float db;
+        if (c.lastBin >= c.firstBin)
+            db = *std::max_element(spectrumDb.begin() + c.firstBin, spectrumDb.begin() + c.lastBin + 1);
+        else
+            db = spectrumDb[(size_t) c.firstBin] + c.fraction * (spectrumDb[(size_t) c.firstBin + 1] - spectrumDb[(size_t) c.firstBin]);
 
-        // Convert to dB (with floor at -60dB)
-        float db = magnitude > 0.0001f ? 20.0f * std::log10(magnitude) : -60.0f;
-        db = juce::jlimit(-60.0f, 6.0f, db);
+        // Floor at -60dB, +6dB at the top
+        db = juce::jlimit(-60.0f, 6.0f, db + boostDb);
 
         // Map dB to Y position (-60dB at bottom, +6dB at top)
         float normalizedDb = (db + 60.0f) / 66.0f;  // 0 to 1
-        float y = bounds.getHeight() * (1.0f - normalizedDb);
+        float x = bounds.getX() + (float) column;
+        float y = bounds.getY() + bounds.getHeight() * (1.0f - normalizedDb);
 
-        if (!pathStarted)
-        {
-            spectrumPath.startNewSubPath(bounds.getX() + x, bounds.getY() + y);
-            pathStarted = true;
-        }
+        if (column == 0)
+            spectrumPath.startNewSubPath(x, y);
         else
-        {
-            spectrumPath.lineTo(bounds.getX() + x, bounds.getY() + y);
-        }
+            spectrumPath.lineTo(x, y);
     }
 
     // Draw filled spectrum
@@ -332,7 +476,7 @@ void EQVisualizer::drawSpectrum(juce::Graphics& g, const std::array<float, fftSi
     g.strokePath(spectrumPath, juce::PathStrokeType(1.5f));
 }
 
-void EQVisualizer::paint(juce::Graphics& g)
+void EQVisualizer::paintGrid(juce::Graphics& g)
 {
     auto bounds = getLocalBounds().toFloat();
 
@@ -379,10 +523,19 @@ void EQVisualizer::paint(juce::Graphics& g)
     g.drawText("+12", (int)(bounds.getX() + 2), (int)(bounds.getY() + dbToY(12.0f, bounds.getHeight()) - 5), 20, 10, juce::Justification::left);
     g.drawText("0", (int)(bounds.getX() + 2), (int)(bounds.getY() + zeroY - 5), 20, 10, juce::Justification::left);
     g.drawText("-12", (int)(bounds.getX() + 2), (int)(bounds.getY() + dbToY(-12.0f, bounds.getHeight()) - 5), 20, 10, juce::Justification::left);
+}
+
+void EQVisualizer::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    float zeroY = dbToY(0.0f, bounds.getHeight());
+
+    gridLayer.draw(g, getLocalBounds(), [this](juce::Graphics& gg) { paintGrid(gg); });
 
     // Draw spectrum analyzer (input = faint blue, output = brighter green)
-    drawSpectrum(g, processor.getInputSpectrum(), juce::Colour(colorInputSpectrum), 0.4f, bounds);
-    drawSpectrum(g, processor.getOutputSpectrum(), juce::Colour(colorOutputSpectrum), 0.7f, bounds);
+    const auto& spectrum = processor.getSpectrum();
+    drawSpectrum(g, spectrum.input, juce::Colour(colorInputSpectrum), 0.4f, bounds);
+    drawSpectrum(g, spectrum.output, juce::Colour(colorOutputSpectrum), 0.7f, bounds);
 
     // Band colors
     const juce::Colour bandColors[] = {
@@ -394,59 +547,14 @@ void EQVisualizer::paint(juce::Graphics& g)
         juce::Colour(colorHighShelf)  // High shelf - White
     };
 
-    // Draw individual band curves
-    for (int band = 0; band < 6; ++band)
-    {
-        juce::Path bandPath;
-        bool pathStarted = false;
-
-        for (float x = 0; x < bounds.getWidth(); x += 2.0f)
-        {
-            float freq = 20.0f * std::pow(1000.0f, x / bounds.getWidth());
-            float magnitude = getBandMagnitudeAtFrequency(freq, band);
-            float db = juce::Decibels::gainToDecibels(magnitude, -24.0f);
-            db = juce::jlimit(-18.0f, 18.0f, db);
-
-            float y = dbToY(db, bounds.getHeight());
-
-            if (!pathStarted)
-            {
-                bandPath.startNewSubPath(bounds.getX() + x, bounds.getY() + y);
-                pathStarted = true;
-            }
-            else
-            {
-                bandPath.lineTo(bounds.getX() + x, bounds.getY() + y);
-            }
-        }
+    // EQ curves (rebuilt only when the EQ or the size changed)
+    updateResponseCurves(bounds);
 
-        // Draw band curve with transparency
-        g.setColour(bandColors[band].withAlpha(0.5f));
-        g.strokePath(bandPath, juce::PathStrokeType(1.5f));
-    }
-
-    // Draw combined frequency response curve
-    juce::Path responsePath;
-    bool pathStarted = false;
-
-    for (float x = 0; x < bounds.getWidth(); x += 2.0f)
+    // Draw individual band curves with transparency
+    for (int band = 0; band < Equalizer::NumBands; ++band)
     {
-        float freq = 20.0f * std::pow(1000.0f, x / bounds.getWidth());
-        float magnitude = processor.getEQMagnitudeAtFrequency(freq);
-        float db = juce::Decibels::gainToDecibels(magnitude, -24.0f);
-        db = juce::jlimit(-18.0f, 18.0f, db);
-
-        float y = dbToY(db, bounds.getHeight());
-
-        if (!pathStarted)
-        {
-            responsePath.startNewSubPath(bounds.getX() + x, bounds.getY() + y);
-            pathStarted = true;
-        }
-        else
-        {
-            responsePath.lineTo(bounds.getX() + x, bounds.getY() + y);
-        }
+        g.setColour(bandColors[band].withAlpha(0.5f));
+        g.strokePath(bandPaths[(size_t) band], juce::PathStrokeType(1.5f));
     }
 
     // Fill under combined curve with gradient
@@ -490,6 +598,9 @@ CompressorSection::CompressorSection()
     setupSlider(releaseSlider, releaseLabel, "RELEASE");
     setupSlider(makeupSlider, makeupLabel, "MAKEUP");
     setupSlider(kneeSlider, kneeLabel, "KNEE");
+    setupSlider(lookaheadSlider, lookaheadLabel, "LOOK");
+    setupSlider(rmsBlendSlider, rmsBlendLabel, "RMS");
+    setupSlider(rmsWindowSlider, rmsWindowLabel, "WINDOW");
 
     thresholdSlider.setTextValueSuffix(" dB");
     ratioSlider.setTextValueSuffix(":1");
@@ -497,6 +608,9 @@ CompressorSection::CompressorSection()
     releaseSlider.setTextValueSuffix(" ms");
     makeupSlider.setTextValueSuffix(" dB");
     kneeSlider.setTextValueSuffix(" dB");
+    lookaheadSlider.setTextValueSuffix(" ms");
+    rmsBlendSlider.setTextValueSuffix(" %");
+    rmsWindowSlider.setTextValueSuffix(" ms");
 
     // Footswitch-style buttons (invisible, drawn manually)
     autoReleaseButton.setClickingTogglesState(true);
@@ -518,6 +632,9 @@ CompressorSection::~CompressorSection()
     releaseSlider.setLookAndFeel(nullptr);
     makeupSlider.setLookAndFeel(nullptr);
     kneeSlider.setLookAndFeel(nullptr);
+    lookaheadSlider.setLookAndFeel(nullptr);
+    rmsBlendSlider.setLookAndFeel(nullptr);
+    rmsWindowSlider.setLookAndFeel(nullptr);
 }
 
 void CompressorSection::setupSlider(juce::Slider& slider, juce::Label& label, const juce::String& text)
@@ -536,7 +653,7 @@ void CompressorSection::setupSlider(juce::Slider& slider, juce::Label& label, co
     addAndMakeVisible(label);
 }
 
-void CompressorSection::paint(juce::Graphics& g)
+void CompressorSection::paintBackground(juce::Graphics& g)
 {
     auto bounds = getLocalBounds().toFloat().reduced(4);
 
@@ -561,6 +678,12 @@ void CompressorSection::paint(juce::Graphics& g)
     g.setColour(juce::Colours::white.withAlpha(0.9f));
     g.setFont(juce::FontOptions(13.0f).withStyle("Bold"));
     g.drawText("COMPRESSOR", bounds.getX() + 30, bounds.getY() + 6, 120, 20, juce::Justification::centredLeft);
+}
+
+void CompressorSection::paint(juce::Graphics& g)
+{
+    // Panel, screws and title (pre-rendered)
+    background.draw(g, getLocalBounds(), [this](juce::Graphics& bg) { paintBackground(bg); });
 
     // Draw small toggle buttons in header area
     auto autoBounds = autoReleaseButton.getBounds().toFloat();
@@ -594,6 +717,8 @@ void CompressorSection::paint(juce::Graphics& g)
 
 void CompressorSection::resized()
 {
+    background.invalidate();
+
     auto bounds = getLocalBounds().reduced(10);
 
     // Small toggle buttons in header area (moved left to avoid corner bolt)
@@ -604,7 +729,7 @@ void CompressorSection::resized()
 
     const int knobSize = 50;
     const int labelHeight = 14;
-    const int spacing = 58;  // Fixed spacing to prevent overlap
+    const int spacing = 55;  // Fixed spacing to prevent overlap (text boxes are 55 wide)
 
     int x = 25;
     int y = bounds.getY();
@@ -622,6 +747,9 @@ void CompressorSection::resized()
     placeKnob(releaseSlider, releaseLabel);
     placeKnob(makeupSlider, makeupLabel);
     placeKnob(kneeSlider, kneeLabel);
+    placeKnob(lookaheadSlider, lookaheadLabel);
+    placeKnob(rmsBlendSlider, rmsBlendLabel);
+    placeKnob(rmsWindowSlider, rmsWindowLabel);
 
     // GR Meter - now has more space
     grMeter.setBounds(x + 15, y + 18, getWidth() - x - 40, 22);
@@ -692,7 +820,7 @@ void DeEsserSection::setupSlider(juce::Slider& slider, juce::Label& label, const
     addAndMakeVisible(label);
 }
 
-void DeEsserSection::paint(juce::Graphics& g)
+void DeEsserSection::paintBackground(juce::Graphics& g)
 {
     auto bounds = getLocalBounds().toFloat().reduced(4);
 
@@ -717,21 +845,41 @@ void DeEsserSection::paint(juce::Graphics& g)
     g.setColour(juce::Colours::white.withAlpha(0.9f));
     g.setFont(juce::FontOptions(13.0f).withStyle("Bold"));
     g.drawText("DE-ESSER", bounds.getX() + 30, bounds.getY() + 6, 100, 20, juce::Justification::centredLeft);
+}
+
+juce::Rectangle<float> DeEsserSection::getActivityLEDBounds() const
+{
+    auto bounds = getLocalBounds().toFloat().reduced(4);
+    return { bounds.getX() + 130, bounds.getY() + 12, 8, 8 };
+}
+
+void DeEsserSection::setActive(bool active)
+{
+    if (active == isActive)
+        return;
+
+    isActive = active;
+    repaint(getActivityLEDBounds().expanded(4).getSmallestIntegerContainer());
+}
+
+void DeEsserSection::paint(juce::Graphics& g)
+{
+    // Panel, screws and title (pre-rendered)
+    background.draw(g, getLocalBounds(), [this](juce::Graphics& bg) { paintBackground(bg); });
 
     // Activity LED (next to title)
-    float ledX = bounds.getX() + 130;
-    float ledY = bounds.getY() + 12;
+    auto ledBounds = getActivityLEDBounds();
     if (isActive)
     {
         g.setColour(VoxColors::led.withAlpha(0.4f));
-        g.fillEllipse(ledX - 3, ledY - 3, 14, 14);
+        g.fillEllipse(ledBounds.expanded(3));
         g.setColour(VoxColors::led);
     }
     else
     {
         g.setColour(VoxColors::led.withAlpha(0.2f));
     }
-    g.fillEllipse(ledX, ledY, 8, 8);
+    g.fillEllipse(ledBounds);
 
     // Draw small toggle buttons in header area
     auto listenBounds = listenButton.getBounds().toFloat();
@@ -765,6 +913,8 @@ void DeEsserSection::paint(juce::Graphics& g)
 
 void DeEsserSection::resized()
 {
+    background.invalidate();
+
     auto bounds = getLocalBounds().reduced(10);
 
     // Small toggle buttons in header area (moved left to avoid corner bolt)
@@ -859,6 +1009,14 @@ EQSection::EQSection(VoxProcAudioProcessor& p)
     bypassButton.setAlpha(0.0f);
     addAndMakeVisible(bypassButton);
 
+    modeSelector.addItem("Standard", 1);
+    modeSelector.addItem("Linear Phase", 2);
+    modeSelector.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff0a0a0a));
+    modeSelector.setColour(juce::ComboBox::textColourId, VoxColors::lcdGreen);
+    modeSelector.setColour(juce::ComboBox::outlineColourId, VoxColors::panelBorder);
+    modeSelector.setColour(juce::ComboBox::arrowColourId, VoxColors::lcdGreen);
+    addAndMakeVisible(modeSelector);
+
     addAndMakeVisible(eqVisualizer);
 }
 
@@ -912,7 +1070,7 @@ void EQSection::setupGainSlider(juce::Slider& slider, juce::Label& label, const
     addAndMakeVisible(label);
 }
 
-void EQSection::paint(juce::Graphics& g)
+void EQSection::paintBackground(juce::Graphics& g)
 {
     auto bounds = getLocalBounds().toFloat().reduced(4);
 
@@ -937,6 +1095,12 @@ void EQSection::paint(juce::Graphics& g)
     g.setColour(juce::Colours::white.withAlpha(0.9f));
     g.setFont(juce::FontOptions(13.0f).withStyle("Bold"));
     g.drawText("EQUALIZER", bounds.getX() + 30, bounds.getY() + 6, 100, 20, juce::Justification::centredLeft);
+}
+
+void EQSection::paint(juce::Graphics& g)
+{
+    // Panel, screws and title (pre-rendered)
+    background.draw(g, getLocalBounds(), [this](juce::Graphics& bg) { paintBackground(bg); });
 
     // Draw small toggle button in header area
     auto bypassBounds = bypassButton.getBounds().toFloat();
@@ -956,10 +1120,13 @@ void EQSection::paint(juce::Graphics& g)
 
 void EQSection::resized()
 {
+    background.invalidate();
+
     auto bounds = getLocalBounds().reduced(10);
 
     // Small toggle button in header area (moved left to avoid corner bolt)
     bypassButton.setBounds(getWidth() - 95, 8, 55, 18);
+    modeSelector.setBounds(getWidth() - 205, 8, 104, 18);
 
     bounds.removeFromTop(28);
 
@@ -1068,6 +1235,29 @@ VoxProcAudioProcessorEditor::VoxProcAudioProcessorEditor(VoxProcAudioProcessor&
     outputGainLabel.setFont(juce::FontOptions(9.0f).withStyle("Bold"));
     addAndMakeVisible(outputGainLabel);
 
+    // Oversampling selectors
+    oversamplingSelector.addItem("1x", 1);
+    oversamplingSelector.addItem("2x", 2);
+    oversamplingSelector.addItem("4x", 3);
+    oversamplingSelector.addItem("8x", 4);
+    oversamplingFilterSelector.addItem("Linear", 1);
+    oversamplingFilterSelector.addItem("Min Phase", 2);
+
+    for (auto* selector : { &oversamplingSelector, &oversamplingFilterSelector })
+    {
+        selector->setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff0a0a0a));
+        selector->setColour(juce::ComboBox::textColourId, VoxColors::lcdGreen);
+        selector->setColour(juce::ComboBox::outlineColourId, VoxColors::panelBorder);
+        selector->setColour(juce::ComboBox::arrowColourId, VoxColors::lcdGreen);
+        addAndMakeVisible(*selector);
+    }
+
+    oversamplingLabel.setText("OVERSAMPLE", juce::dontSendNotification);
+    oversamplingLabel.setJustificationType(juce::Justification::centredLeft);
+    oversamplingLabel.setColour(juce::Label::textColourId, VoxColors::textSecondary);
+    oversamplingLabel.setFont(juce::FontOptions(9.0f).withStyle("Bold"));
+    addAndMakeVisible(oversamplingLabel);
+
     // Horizontal meters for header (like PDLBRD)
     inputMeter.setVertical(false);
     outputMeter.setVertical(false);
@@ -1088,6 +1278,9 @@ VoxProcAudioProcessorEditor::VoxProcAudioProcessorEditor(VoxProcAudioProcessor&
     compReleaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "compRelease", compressorSection.releaseSlider);
     compMakeupAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "compMakeup", compressorSection.makeupSlider);
     compKneeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "compKnee", compressorSection.kneeSlider);
+    compLookaheadAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "compLookahead", compressorSection.lookaheadSlider);
+    compRMSBlendAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "compRMSBlend", compressorSection.rmsBlendSlider);
+    compRMSWindowAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "compRMSWindow", compressorSection.rmsWindowSlider);
     compAutoReleaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "compAutoRelease", compressorSection.autoReleaseButton);
     compBypassAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "compBypass", compressorSection.bypassButton);
 
@@ -1116,33 +1309,86 @@ VoxProcAudioProcessorEditor::VoxProcAudioProcessorEditor(VoxProcAudioProcessor&
     eqHighShelfFreqAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "eqHighShelfFreq", eqSection.highShelfFreqSlider);
     eqHighShelfGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "eqHighShelfGain", eqSection.highShelfGainSlider);
     eqBypassAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "eqBypass", eqSection.bypassButton);
+    eqModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "eqMode", eqSection.modeSelector);
 
     // Global
     inputGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "inputGain", inputGainSlider);
     outputGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "outputGain", outputGainSlider);
+    oversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "oversampling", oversamplingSelector);
+    oversamplingFilterAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "oversamplingFilter", oversamplingFilterSelector);
 
     setSize(700, 780);  // Taller to fit all EQ controls including Q knobs
-    startTimerHz(30);
+    startActiveFrames();
 }
 
 VoxProcAudioProcessorEditor::~VoxProcAudioProcessorEditor()
 {
     stopTimer();
+    vblankAttachment.reset();
     inputGainSlider.setLookAndFeel(nullptr);
     outputGainSlider.setLookAndFeel(nullptr);
 }
 
+void VoxProcAudioProcessorEditor::startActiveFrames()
+{
+    stopTimer();
+    lastFrameTime = lastActivityTime = juce::Time::getMillisecondCounterHiRes() * 0.001;
+
+    if (vblankAttachment == nullptr)
+        vblankAttachment = std::make_unique<juce::VBlankAttachment>(this, [this] { renderFrame(); });
+}
+
+void VoxProcAudioProcessorEditor::startIdlePolling()
+{
+    vblankAttachment.reset();
+    startTimerHz(idlePollRateHz);
+}
+
+bool VoxProcAudioProcessorEditor::hasActivity()
+{
+    const auto eqVersion = audioProcessor.getEQDisplayCoefficients().version;
+    const bool eqChanged = eqVersion != lastEQVersion;
+    lastEQVersion = eqVersion;
+
+    return eqChanged
+        || audioProcessor.getInputLevel() > silenceLevel
+        || audioProcessor.getOutputLevel() > silenceLevel
+        || audioProcessor.getCompressorGainReduction() > 0.01f
+        || audioProcessor.isDeEsserActive();
+}
+
 void VoxProcAudioProcessorEditor::timerCallback()
 {
+    // Idle: wake up when signal (or a new EQ design) arrives
+    if (hasActivity())
+        startActiveFrames();
+}
+
+void VoxProcAudioProcessorEditor::renderFrame()
+{
+    const double now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    const double elapsed = now - lastFrameTime;
+
+    // Skip vblanks that come faster than the frame rate cap (high refresh displays)
+    if (elapsed < 0.9 / maxFrameRateHz)
+        return;
+
+    lastFrameTime = now;
+
+    // Meter ballistics per reference frame, scaled to the actual frame time
+    const float frames = (float) (juce::jmin(elapsed, 0.25) * referenceFrameRateHz);
+    const float attack = std::pow(0.8f, frames);
+    const float release = std::pow(0.92f, frames);
+
     // Update levels
     float targetIn = audioProcessor.getInputLevel();
     float targetOut = audioProcessor.getOutputLevel();
 
-    smoothedInputLevel = smoothedInputLevel * 0.8f + targetIn * 0.2f;
-    smoothedOutputLevel = smoothedOutputLevel * 0.8f + targetOut * 0.2f;
+    smoothedInputLevel = smoothedInputLevel * attack + targetIn * (1.0f - attack);
+    smoothedOutputLevel = smoothedOutputLevel * attack + targetOut * (1.0f - attack);
 
-    if (targetIn < smoothedInputLevel) smoothedInputLevel *= 0.92f;
-    if (targetOut < smoothedOutputLevel) smoothedOutputLevel *= 0.92f;
+    if (targetIn < smoothedInputLevel) smoothedInputLevel *= release;
+    if (targetOut < smoothedOutputLevel) smoothedOutputLevel *= release;
 
     inputMeter.setLevel(smoothedInputLevel);
     outputMeter.setLevel(smoothedOutputLevel);
@@ -1152,12 +1398,18 @@ void VoxProcAudioProcessorEditor::timerCallback()
     deEsserSection.grMeter.setGainReduction(audioProcessor.getDeEsserGainReduction());
     deEsserSection.setActive(audioProcessor.isDeEsserActive());
 
-    // Update EQ parameters and repaint visualizer
-    audioProcessor.updateEQForVisualization();
+    // Repaint visualizer (spectrum; the EQ curves follow the published design)
     eqSection.eqVisualizer.repaint();
+
+    // Drop to idle polling once the meters have settled on silence and the
+    // spectrum has had time to decay
+    if (hasActivity() || smoothedInputLevel > silenceLevel || smoothedOutputLevel > silenceLevel)
+        lastActivityTime = now;
+    else if (now - lastActivityTime > idleHoldSeconds)
+        startIdlePolling();
 }
 
-void VoxProcAudioProcessorEditor::paint(juce::Graphics& g)
+void VoxProcAudioProcessorEditor::paintBackground(juce::Graphics& g)
 {
     // Dark background (matching PDLBRD)
     g.fillAll(VoxColors::background);
@@ -1188,8 +1440,15 @@ void VoxProcAudioProcessorEditor::paint(juce::Graphics& g)
     g.drawText("OUT", 480, 28, 24, 12, juce::Justification::left);
 }
 
+void VoxProcAudioProcessorEditor::paint(juce::Graphics& g)
+{
+    background.draw(g, getLocalBounds(), [this](juce::Graphics& bg) { paintBackground(bg); });
+}
+
 void VoxProcAudioProcessorEditor::resized()
 {
+    background.invalidate();
+
     const int headerHeight = 50;
     const int margin = 8;
 
@@ -1206,6 +1465,9 @@ void VoxProcAudioProcessorEditor::resized()
     inputGainSlider.setBounds(180, 5, 40, 40);
     outputGainLabel.setBounds(230, 8, 40, 12);
     outputGainSlider.setBounds(275, 5, 40, 40);
+    oversamplingLabel.setBounds(328, 4, 140, 12);
+    oversamplingSelector.setBounds(328, 18, 54, 22);
+    oversamplingFilterSelector.setBounds(386, 18, 84, 22);
 
     auto bounds = getLocalBounds();
     bounds.removeFromTop(headerHeight);
@@ -3,6 +3,54 @@
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
 
+//==============================================================================
+// Pre-rendered static artwork (panel backgrounds, grids, knob bodies). The
+// image is rendered at the physical pixel scale of the context it's drawn
+// into and only re-rendered when that scale or the area size changes, or
+// after invalidate().
+//==============================================================================
+class CachedLayer
+{
+public:
+    void invalidate() { image = juce::Image(); }
+
+    // Draws the cached image over area, calling render(g) first if it's stale.
+    // render draws in the caller's coordinate space.
+    template <typename RenderFunction>
+    void draw(juce::Graphics& g, juce::Rectangle<int> area, RenderFunction&& render)
+    {
+        if (area.isEmpty())
+            return;
+
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+        if (image.isNull() || area.getWidth() != imageArea.getWidth()
+            || area.getHeight() != imageArea.getHeight() || scale != imageScale)
+        {
+            const int imageWidth = juce::jmax(1, juce::roundToInt((float) area.getWidth() * scale));
+            const int imageHeight = juce::jmax(1, juce::roundToInt((float) area.getHeight() * scale));
+            image = juce::Image(juce::Image::ARGB, imageWidth, imageHeight, true);
+
+            juce::Graphics imageGraphics(image);
+            imageGraphics.addTransform(juce::AffineTransform::translation((float) -area.getX(), (float) -area.getY())
+                                           .scaled((float) imageWidth / (float) area.getWidth(),
+                                                   (float) imageHeight / (float) area.getHeight()));
+            render(imageGraphics);
+
+            imageScale = scale;
+        }
+
+        imageArea = area;
+        g.setOpacity(1.0f);  // Images are drawn with the alpha of the current colour
+        g.drawImage(image, area.toFloat());
+    }
+
+private:
+    juce::Image image;
+    juce::Rectangle<int> imageArea;
+    float imageScale = 0.0f;
+};
+
 //==============================================================================
 // Custom LookAndFeel for PDLBRD-style knobs (knurled edge with indicator line)
 //==============================================================================
@@ -13,6 +61,8 @@ public:
 
     void setAccentColour(juce::Colour c) { accentColour = c; }
 
+    // Only the indicator and centre cap are drawn per repaint; the knob body
+    // comes from a cache keyed by radius and display scale.
     void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
                           float sliderPosProportional, float, float,
                           juce::Slider&) override
@@ -21,7 +71,70 @@ public:
         float cx = bounds.getCentreX();
         float cy = bounds.getCentreY();
         float radius = juce::jmin(bounds.getWidth(), bounds.getHeight()) / 2.0f - 2.0f;
+        float innerRadius = radius * 0.78f;
+
+        if (radius <= 0.0f)
+            return;
 
+        // Knob body. The image sits on whole pixels, so the live elements are
+        // drawn around its centre rather than the slider's.
+        const int bodySize = 2 * (int) std::ceil(radius) + 2;
+        auto bodyArea = juce::Rectangle<int>(bodySize, bodySize)
+                            .withCentre({ juce::roundToInt(cx), juce::roundToInt(cy) });
+        cx = bodyArea.toFloat().getCentreX();
+        cy = bodyArea.toFloat().getCentreY();
+
+        getKnobBody(g, radius).draw(g, bodyArea, [&](juce::Graphics& bg) { drawKnobBody(bg, cx, cy, radius); });
+
+        // Indicator line (7 o'clock to 5 o'clock, clockwise)
+        float indicatorAngle = juce::jmap(sliderPosProportional, 0.0f, 1.0f, -1.047f, 4.189f) + juce::MathConstants<float>::pi;
+        float indicatorLength = innerRadius * 0.65f;
+        float ix1 = cx + (innerRadius * 0.2f) * std::cos(indicatorAngle);
+        float iy1 = cy + (innerRadius * 0.2f) * std::sin(indicatorAngle);
+        float ix2 = cx + indicatorLength * std::cos(indicatorAngle);
+        float iy2 = cy + indicatorLength * std::sin(indicatorAngle);
+        g.setColour(accentColour);
+        g.drawLine(ix1, iy1, ix2, iy2, 3.0f);
+
+        // Center cap
+        float capRadius = innerRadius * 0.25f;
+        g.setColour(juce::Colour(0xff404040));
+        g.fillEllipse(cx - capRadius, cy - capRadius, capRadius * 2.0f, capRadius * 2.0f);
+    }
+
+private:
+    juce::Colour accentColour = juce::Colours::white;
+
+    // Cached knob bodies, one per radius. Cleared when the display scale changes.
+    struct KnobBody
+    {
+        float radius = 0.0f;
+        CachedLayer layer;
+    };
+
+    std::vector<std::unique_ptr<KnobBody>> knobBodies;
+    float knobBodyScale = 0.0f;
+
+    CachedLayer& getKnobBody(juce::Graphics& g, float radius)
+    {
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        if (scale != knobBodyScale)
+        {
+            knobBodies.clear();
+            knobBodyScale = scale;
+        }
+
+        for (auto& body : knobBodies)
+            if (body->radius == radius)
+                return body->layer;
+
+        knobBodies.push_back(std::make_unique<KnobBody>());
+        knobBodies.back()->radius = radius;
+        return knobBodies.back()->layer;
+    }
+
+    static void drawKnobBody(juce::Graphics& g, float cx, float cy, float radius)
+    {
         // Outer ring (knurled edge)
         g.setColour(juce::Colour(0xff303030));
         g.fillEllipse(cx - radius, cy - radius, radius * 2.0f, radius * 2.0f);
@@ -49,25 +162,7 @@ public:
         // Ring
         g.setColour(juce::Colour(0xff606060));
         g.drawEllipse(cx - innerRadius, cy - innerRadius, innerRadius * 2.0f, innerRadius * 2.0f, 1.0f);
-
-        // Indicator line (7 o'clock to 5 o'clock, clockwise)
-        float indicatorAngle = juce::jmap(sliderPosProportional, 0.0f, 1.0f, -1.047f, 4.189f) + juce::MathConstants<float>::pi;
-        float indicatorLength = innerRadius * 0.65f;
-        float ix1 = cx + (innerRadius * 0.2f) * std::cos(indicatorAngle);
-        float iy1 = cy + (innerRadius * 0.2f) * std::sin(indicatorAngle);
-        float ix2 = cx + indicatorLength * std::cos(indicatorAngle);
-        float iy2 = cy + indicatorLength * std::sin(indicatorAngle);
-        g.setColour(accentColour);
-        g.drawLine(ix1, iy1, ix2, iy2, 3.0f);
-
-        // Center cap
-        float capRadius = innerRadius * 0.25f;
-        g.setColour(juce::Colour(0xff404040));
-        g.fillEllipse(cx - capRadius, cy - capRadius, capRadius * 2.0f, capRadius * 2.0f);
     }
-
-private:
-    juce::Colour accentColour = juce::Colours::white;
 };
 
 //==============================================================================
@@ -76,13 +171,23 @@ private:
 class LevelMeter : public juce::Component
 {
 public:
-    void setLevel(float newLevel) { level = newLevel; repaint(); }
-    void setVertical(bool v) { vertical = v; }
+    // Repaints only the span the bar moved over, or the whole bar when it
+    // changes colour. Nothing is repainted if the bar stays on the same pixel.
+    void setLevel(float newLevel);
+    void setVertical(bool v) { vertical = v; updateBar(); }
     void paint(juce::Graphics& g) override;
+    void resized() override { updateBar(); }
 
 private:
     float level = 0.0f;
     bool vertical = true;
+
+    // What the last paint showed (or the next one will)
+    int barLength = 0;      // Pixels along the meter
+    int colourZone = 0;     // 0 = green, 1 = yellow, 2 = red
+
+    float getNormalizedLevel() const;
+    void updateBar();
 };
 
 //==============================================================================
@@ -91,11 +196,18 @@ private:
 class GainReductionMeter : public juce::Component
 {
 public:
-    void setGainReduction(float gr) { gainReduction = gr; repaint(); }
+    // Repaints only the segments that switched on or off
+    void setGainReduction(float gr);
     void paint(juce::Graphics& g) override;
 
 private:
+    static constexpr int numSegments = 12;
+
     float gainReduction = 0.0f;
+    int litSegments = 0;
+
+    static int getLitSegments(float gainReductionDb);
+    juce::Rectangle<float> getSegmentBounds(int index) const;
 };
 
 //==============================================================================
@@ -106,6 +218,7 @@ class EQVisualizer : public juce::Component
 public:
     EQVisualizer(VoxProcAudioProcessor& p) : processor(p) {}
     void paint(juce::Graphics& g) override;
+    void resized() override { gridLayer.invalidate(); }
 
     // Band colors matching synth page style
     static constexpr uint32_t colorHPF       = 0xffff5555;  // Red
@@ -122,13 +235,46 @@ private:
     VoxProcAudioProcessor& processor;
     float freqToX(float freq, float width) const;
     float dbToY(float db, float height) const;
-    float binToFreq(int bin, double sampleRate) const;
 
-    // Calculate magnitude for a single band at a given frequency
-    float getBandMagnitudeAtFrequency(float freq, int bandIndex) const;
+    // Background, grid and axis labels (pre-rendered)
+    CachedLayer gridLayer;
+    void paintGrid(juce::Graphics& g);
+
+    // EQ response curves, drawn from the visualizer's own copy of the
+    // published coefficients. The cos/sin grid is rebuilt on resize or sample
+    // rate change; a band's curve only when its coefficients change. The
+    // combined curve is the product of the enabled bands.
+    Equalizer::CoefficientSet eqCoefficients;
+    Equalizer::ResponseGrid responseGrid;
+    juce::Rectangle<float> responseBounds;
+    std::array<std::vector<float>, Equalizer::NumBands> bandMagnitudes;
+    std::vector<float> combinedMagnitudes;
+    std::vector<float> curveDb;
+    std::array<juce::Path, Equalizer::NumBands> bandPaths;
+    juce::Path responsePath;
+
+    void updateResponseCurves(juce::Rectangle<float> bounds);
+    void buildResponsePath(juce::Path& path, const std::vector<float>& magnitudes, juce::Rectangle<float> bounds);
+
+    // Spectrum display: the FFT bins under each pixel column. A column
+    // spanning several bins shows their maximum; one narrower than a bin
+    // interpolates between its two neighbours. Rebuilt only when the width
+    // or the sample rate changes.
+    struct SpectrumColumn
+    {
+        int firstBin = 0;
+        int lastBin = 0;         // < firstBin when interpolating
+        float fraction = 0.0f;   // between firstBin and firstBin + 1
+    };
 
-    // Draw spectrum analyzer
-    void drawSpectrum(juce::Graphics& g, const std::array<float, fftSize / 2>& spectrum,
+    std::vector<SpectrumColumn> spectrumColumns;
+    float spectrumColumnsWidth = 0.0f;
+    double spectrumColumnsSampleRate = 0.0;
+
+    void updateSpectrumColumns(float width, double sampleRate);
+
+    // Draw spectrum analyzer (spectrum in dB, see SpectrumFrame)
+    void drawSpectrum(juce::Graphics& g, const std::array<float, fftSize / 2>& spectrumDb,
                       juce::Colour colour, float alpha, juce::Rectangle<float> bounds);
 };
 
@@ -143,14 +289,18 @@ public:
     void paint(juce::Graphics& g) override;
     void resized() override;
 
-    juce::Slider thresholdSlider, ratioSlider, attackSlider, releaseSlider, makeupSlider, kneeSlider;
-    juce::Label thresholdLabel, ratioLabel, attackLabel, releaseLabel, makeupLabel, kneeLabel;
+    juce::Slider thresholdSlider, ratioSlider, attackSlider, releaseSlider, makeupSlider, kneeSlider, lookaheadSlider;
+    juce::Slider rmsBlendSlider, rmsWindowSlider;
+    juce::Label thresholdLabel, ratioLabel, attackLabel, releaseLabel, makeupLabel, kneeLabel, lookaheadLabel;
+    juce::Label rmsBlendLabel, rmsWindowLabel;
     juce::ToggleButton autoReleaseButton { "Auto" };
     juce::ToggleButton bypassButton { "Bypass" };
     GainReductionMeter grMeter;
 
 private:
     std::unique_ptr<VoxProcLookAndFeel> lookAndFeel;
+    CachedLayer background;
+    void paintBackground(juce::Graphics& g);
     void setupSlider(juce::Slider& slider, juce::Label& label, const juce::String& text);
 };
 
@@ -170,11 +320,15 @@ public:
     juce::ToggleButton bypassButton { "Bypass" };
     GainReductionMeter grMeter;
 
-    void setActive(bool active) { isActive = active; repaint(); }
+    // Repaints just the activity LED, and only when it toggles
+    void setActive(bool active);
 
 private:
     std::unique_ptr<VoxProcLookAndFeel> lookAndFeel;
+    CachedLayer background;
+    void paintBackground(juce::Graphics& g);
     bool isActive = false;
+    juce::Rectangle<float> getActivityLEDBounds() const;
     void setupSlider(juce::Slider& slider, juce::Label& label, const juce::String& text);
 };
 
@@ -212,11 +366,14 @@ public:
     juce::Label highShelfFreqLabel, highShelfGainLabel;
 
     juce::ToggleButton bypassButton { "Bypass" };
+    juce::ComboBox modeSelector;  // Standard / linear phase
 
     EQVisualizer eqVisualizer;
 
 private:
     std::unique_ptr<VoxProcLookAndFeel> lookAndFeel;
+    CachedLayer background;
+    void paintBackground(juce::Graphics& g);
     void setupSlider(juce::Slider& slider, juce::Label& label, const juce::String& text);
     void setupGainSlider(juce::Slider& slider, juce::Label& label, const juce::String& text);
 };
@@ -238,6 +395,30 @@ public:
 private:
     VoxProcAudioProcessor& audioProcessor;
 
+    // Frame pacing. While there is signal, meters and the spectrum update on
+    // vblank (capped at maxFrameRateHz). After idleHoldSeconds of silence the
+    // editor drops to a slow timer that only polls for signal or an EQ change
+    // and paints nothing.
+    static constexpr double maxFrameRateHz = 60.0;
+    static constexpr double referenceFrameRateHz = 30.0;  // Rate the meter ballistics were tuned at
+    static constexpr int idlePollRateHz = 4;
+    static constexpr double idleHoldSeconds = 2.0;
+    static constexpr float silenceLevel = 1.0e-4f;        // -80 dB
+
+    std::unique_ptr<juce::VBlankAttachment> vblankAttachment;
+    double lastFrameTime = 0.0;
+    double lastActivityTime = 0.0;
+    juce::uint32 lastEQVersion = 0;
+
+    void startActiveFrames();
+    void startIdlePolling();
+    void renderFrame();
+    bool hasActivity();
+
+    // Header and background (pre-rendered)
+    CachedLayer background;
+    void paintBackground(juce::Graphics& g);
+
     // Sections
     CompressorSection compressorSection;
     DeEsserSection deEsserSection;
@@ -246,6 +427,10 @@ private:
     // Global controls
     juce::Slider inputGainSlider, outputGainSlider;
     juce::Label inputGainLabel, outputGainLabel;
+
+    // Oversampling factor and filter; applied when the host next prepares the plugin
+    juce::ComboBox oversamplingSelector, oversamplingFilterSelector;
+    juce::Label oversamplingLabel;
     LevelMeter inputMeter, outputMeter;
 
     float smoothedInputLevel = 0.0f;
@@ -261,6 +446,9 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> compReleaseAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> compMakeupAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> compKneeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> compLookaheadAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> compRMSBlendAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> compRMSWindowAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> compAutoReleaseAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> compBypassAttachment;
 
@@ -289,10 +477,13 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eqHighShelfFreqAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eqHighShelfGainAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> eqBypassAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> eqModeAttachment;
 
     // Global
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> inputGainAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> outputGainAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingFilterAttachment;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoxProcAudioProcessorEditor)
 };
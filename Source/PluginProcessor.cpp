@@ -16,6 +16,9 @@ VoxProcAudioProcessor::VoxProcAudioProcessor()
     compKnee = apvts.getRawParameterValue("compKnee");
     compAutoRelease = apvts.getRawParameterValue("compAutoRelease");
     compBypass = apvts.getRawParameterValue("compBypass");
+    compLookahead = apvts.getRawParameterValue("compLookahead");
+    compRMSBlend = apvts.getRawParameterValue("compRMSBlend");
+    compRMSWindow = apvts.getRawParameterValue("compRMSWindow");
 
     // De-esser parameters
     deessFrequency = apvts.getRawParameterValue("deessFrequency");
@@ -42,13 +45,77 @@ VoxProcAudioProcessor::VoxProcAudioProcessor()
     eqHighShelfFreq = apvts.getRawParameterValue("eqHighShelfFreq");
     eqHighShelfGain = apvts.getRawParameterValue("eqHighShelfGain");
     eqBypass = apvts.getRawParameterValue("eqBypass");
+    eqMode = apvts.getRawParameterValue("eqMode");
 
     // Global parameters
     inputGain = apvts.getRawParameterValue("inputGain");
     outputGain = apvts.getRawParameterValue("outputGain");
+    oversampling = apvts.getRawParameterValue("oversampling");
+    oversamplingFilter = apvts.getRawParameterValue("oversamplingFilter");
+
+    // Snapshots, in the order of the *Index enums
+    for (auto* param : { eqHPFFreq, eqHPFSlope, eqLowShelfFreq, eqLowShelfGain, eqLowMidFreq, eqLowMidGain, eqLowMidQ,
+                         eqMidFreq, eqMidGain, eqMidQ, eqHighMidFreq, eqHighMidGain, eqHighMidQ,
+                         eqHighShelfFreq, eqHighShelfGain, eqBypass, eqMode })
+        equalizerParameters.add(param);
+
+    for (auto* param : { compThreshold, compRatio, compAttack, compRelease, compMakeup, compKnee, compAutoRelease, compBypass,
+                         compLookahead, compRMSBlend, compRMSWindow })
+        compressorParameters.add(param);
+
+    for (auto* param : { deessFrequency, deessThreshold, deessRange, deessMode, deessListen, deessBypass })
+        deEsserParameters.add(param);
+
+    for (auto* param : { inputGain, outputGain })
+        globalParameters.add(param);
+
+    backgroundThread.addTimeSliceClient(this);
+    backgroundThread.startThread();
+}
+
+VoxProcAudioProcessor::~VoxProcAudioProcessor()
+{
+    cancelPendingUpdate();
+    backgroundThread.removeTimeSliceClient(this);
+    backgroundThread.stopThread(1000);
+}
+
+int VoxProcAudioProcessor::useTimeSlice()
+{
+    // Redesigns the filters and rebuilds the compressor's gain curve table
+    // when their settings change; the audio thread just picks up the results
+    const double sampleRate = currentSampleRate.load();
+    equalizer.updateCoefficients(getEqualizerParameters(), sampleRate);
+    deEsser.updateCoefficients(deessFrequency->load(), dynamicsSampleRate.load());
+    compressor.updateGainCurve(compThreshold->load(), compRatio->load(), compKnee->load());
+
+    runAnalyzer();
+    return 10;
+}
+
+int VoxProcAudioProcessor::getModuleLatencySamples() const
+{
+    // The lookahead is aligned to whole base-rate samples (see
+    // getAlignedLookaheadMs()), so it divides exactly by the factor
+    return equalizer.getLatencySamples() + oversampler.getLatencySamples()
+         + compressor.getLatencySamples() / oversampler.getFactor();
 }
 
-VoxProcAudioProcessor::~VoxProcAudioProcessor() {}
+void VoxProcAudioProcessor::publishLatency()
+{
+    const int latency = getModuleLatencySamples();
+
+    if (latency != publishedLatencySamples.load())
+    {
+        publishedLatencySamples.store(latency);
+        triggerAsyncUpdate();
+    }
+}
+
+void VoxProcAudioProcessor::handleAsyncUpdate()
+{
+    setLatencySamples(publishedLatencySamples.load());
+}
 
 juce::AudioProcessorValueTreeState::ParameterLayout VoxProcAudioProcessor::createParameterLayout()
 {
@@ -91,6 +158,23 @@ juce::AudioProcessorValueTreeState::ParameterLayout VoxProcAudioProcessor::creat
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         juce::ParameterID("compBypass", 1), "Comp Bypass", false));
 
+    // Lookahead is reported as latency, so it is not automatable
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("compLookahead", 1), "Comp Lookahead",
+        juce::NormalisableRange<float>(0.0f, Compressor::maxLookaheadMs, 0.1f), 0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("ms").withAutomatable(false)));
+
+    // Detector: 0 % is pure peak, 100 % pure RMS
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("compRMSBlend", 1), "Comp RMS Blend",
+        juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f), 0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("%")));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("compRMSWindow", 1), "Comp RMS Window",
+        juce::NormalisableRange<float>(1.0f, 50.0f, 0.1f, 0.5f), 10.0f,
+        juce::AudioParameterFloatAttributes().withLabel("ms")));
+
     // === DE-ESSER ===
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID("deessFrequency", 1), "De-ess Frequency",
@@ -198,6 +282,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout VoxProcAudioProcessor::creat
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         juce::ParameterID("eqBypass", 1), "EQ Bypass", false));
 
+    // Linear phase adds the FIR's delay, so switching changes the latency and
+    // is not automatable
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("eqMode", 1), "EQ Mode",
+        juce::StringArray{ "Standard", "Linear Phase" }, 0,
+        juce::AudioParameterChoiceAttributes().withAutomatable(false)));
+
     // === GLOBAL ===
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID("inputGain", 1), "Input Gain",
@@ -209,6 +300,19 @@ juce::AudioProcessorValueTreeState::ParameterLayout VoxProcAudioProcessor::creat
         juce::NormalisableRange<float>(-24.0f, 24.0f, 0.1f), 0.0f,
         juce::AudioParameterFloatAttributes().withLabel("dB")));
 
+    // Oversampling of the compressor and de-esser. Changes the latency, so it
+    // is not automatable and only takes effect when the host next prepares
+    // the plugin.
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("oversampling", 1), "Oversampling",
+        juce::StringArray{ "Off", "2x", "4x", "8x" }, 0,
+        juce::AudioParameterChoiceAttributes().withAutomatable(false)));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("oversamplingFilter", 1), "Oversampling Filter",
+        juce::StringArray{ "Linear Phase", "Minimum Phase" }, 0,
+        juce::AudioParameterChoiceAttributes().withAutomatable(false)));
+
     return { params.begin(), params.end() };
 }
 
@@ -226,16 +330,48 @@ void VoxProcAudioProcessor::changeProgramName(int index, const juce::String& new
 void VoxProcAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
-    compressor.prepare(sampleRate, samplesPerBlock);
-    deEsser.prepare(sampleRate, samplesPerBlock);
+
+    // Oversampling for the compressor and de-esser
+    oversampler.prepare(static_cast<int>(oversampling->load()),
+                        static_cast<int>(oversamplingFilter->load()) == 1 ? Oversampler::MinimumPhase : Oversampler::LinearPhase,
+                        samplesPerBlock);
+
+    const int factor = oversampler.getFactor();
+    dynamicsSampleRate = sampleRate * factor;
+
+    // prepare() builds the compressor's gain curve table for its current settings
+    compressor.setThreshold(compThreshold->load());
+    compressor.setRatio(compRatio->load());
+    compressor.setKnee(compKnee->load());
+    compressor.setLookahead(getAlignedLookaheadMs(compLookahead->load()));
+    compressor.prepare(sampleRate * factor, samplesPerBlock * factor);
+
+    // Likewise prepare() designs the filters for their current settings
+    deEsser.setFrequency(deessFrequency->load());
+    deEsser.prepare(sampleRate * factor, samplesPerBlock * factor);
+    equalizer.setParameters(getEqualizerParameters());
+    equalizer.setLinearPhase(eqMode->load() > 0.5f);
     equalizer.prepare(sampleRate, samplesPerBlock);
 
-    // Reset FFT buffers
-    inputFifo.fill(0.0f);
-    outputFifo.fill(0.0f);
-    inputSpectrum.fill(0.0f);
-    outputSpectrum.fill(0.0f);
-    fifoIndex = 0;
+    // The host expects the latency to be set by the end of prepareToPlay();
+    // later changes go through publishLatency()
+    cancelPendingUpdate();
+    publishedLatencySamples.store(getModuleLatencySamples());
+    setLatencySamples(publishedLatencySamples.load());
+
+    // Start the gains on their current values rather than ramping from the
+    // last session's
+    inputGainRamp.reset(DSPUtils::decibelsToLinear(inputGain->load()));
+    outputGainRamp.reset(DSPUtils::decibelsToLinear(outputGain->load()));
+
+    // Push every parameter again on the first block
+    equalizerParameters.invalidate();
+    compressorParameters.invalidate();
+    deEsserParameters.invalidate();
+    globalParameters.invalidate();
+
+    // Reset FFT buffers (done by the analysis thread, which owns them)
+    analyzerResetPending.store(true);
 }
 
 void VoxProcAudioProcessor::releaseResources()
@@ -243,6 +379,7 @@ void VoxProcAudioProcessor::releaseResources()
     compressor.reset();
     deEsser.reset();
     equalizer.reset();
+    oversampler.reset();
 }
 
 bool VoxProcAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
@@ -265,87 +402,219 @@ void VoxProcAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce:
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Apply input gain
-    float inGainLinear = std::pow(10.0f, inputGain->load() / 20.0f);
-    buffer.applyGain(inGainLinear);
+    // Only parameters that changed since the last block reach the DSP
+    if (globalParameters.update())
+    {
+        const int rampLength = static_cast<int>(currentSampleRate.load() * gainRampSeconds);
+
+        if (globalParameters.changed(inputGainIndex))
+            inputGainRamp.setTarget(DSPUtils::decibelsToLinear(globalParameters[inputGainIndex]), rampLength);
+
+        if (globalParameters.changed(outputGainIndex))
+            outputGainRamp.setTarget(DSPUtils::decibelsToLinear(globalParameters[outputGainIndex]), rampLength);
+    }
+
+    // In real time, filter changes are designed on the background thread.
+    // Offline renders design them in place so automation stays sample-exact.
+    const bool designOnAudioThread = isNonRealtime();
+    equalizer.setDesignOnAudioThread(designOnAudioThread);
+    deEsser.setDesignOnAudioThread(designOnAudioThread);
+
+    if (equalizerParameters.update())
+        pushEqualizerParameters();
+
+    if (compressorParameters.update())
+        pushCompressorParameters();
+
+    if (deEsserParameters.update())
+        pushDeEsserParameters();
 
-    // Measure input level (after input gain)
-    float inLevel = 0.0f;
-    for (int ch = 0; ch < totalNumInputChannels; ++ch)
-        inLevel = std::max(inLevel, buffer.getMagnitude(ch, 0, buffer.getNumSamples()));
-    inputLevel.store(inLevel);
+    // Lookahead and EQ mode changes take effect here; the host hears about
+    // them on the message thread
+    publishLatency();
 
-    // Store input samples for FFT (mono mix of input after gain)
-    std::vector<float> inputSamples(buffer.getNumSamples());
-    for (int i = 0; i < buffer.getNumSamples(); ++i)
+    // Input and output stages each make one pass over the block: gain, level
+    // metering and the analyzer's mono mix, written straight into the
+    // analyzer rings. Wait-free: if the analysis thread falls behind, whatever
+    // doesn't fit is dropped and the analyzer simply skips ahead. The space is
+    // reserved here and committed once the output stage has filled it too.
+    const int numChannels = std::min(totalNumInputChannels, buffer.getNumChannels());
+    const int numSamples = buffer.getNumSamples();
+
+    int start1, size1, start2, size2;
+    analyzerFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    DSPUtils::GainRamp::Levels levels;
+
+    // Input stage (levels after input gain)
+    inputGainRamp.applyAndMeasure(buffer.getArrayOfWritePointers(), numChannels, numSamples,
+                                  inputRing.data() + start1, size1, inputRing.data() + start2, size2, levels);
+    inputLevel.store(*std::max_element(levels.peak.begin(), levels.peak.end()));
+    inputRMSLevel.store(*std::max_element(levels.rms.begin(), levels.rms.end()));
+
+    // Process EQ -> Compressor -> De-Esser (signal flow: HPF -> EQ -> Compressor -> De-Esser)
+    processChain(buffer);
+
+    // Output stage
+    outputGainRamp.applyAndMeasure(buffer.getArrayOfWritePointers(), numChannels, numSamples,
+                                   outputRing.data() + start1, size1, outputRing.data() + start2, size2, levels);
+    outputLevel.store(*std::max_element(levels.peak.begin(), levels.peak.end()));
+    outputRMSLevel.store(*std::max_element(levels.rms.begin(), levels.rms.end()));
+
+    analyzerFifo.finishedWrite(size1 + size2);
+}
+
+void VoxProcAudioProcessor::processChain(juce::AudioBuffer<float>& buffer)
+{
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+
+    if (numChannels == 0)
+        return;
+
+    // Per-block work (coefficient and gain curve pickup, processing plans)
+    // happens once; bypassed modules are left out of the tile loop
+    const bool runEqualizer = equalizer.beginBlock();
+    const bool runCompressor = compressor.beginBlock();
+    const bool runDeEsser = deEsser.beginBlock();
+
+    float* leftChannel = buffer.getWritePointer(0);
+    float* rightChannel = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
+    const int tileSize = chainTileSize > 0 ? chainTileSize : numSamples;
+
+    // The linear-phase EQ's convolver works a host block at a time; fed in
+    // tiles it would redo its partial transform for each one. It's first in
+    // the chain, so it runs over the whole block up front.
+    const bool runEqualizerFirst = runEqualizer && equalizer.isLinearPhase();
+
+    if (runEqualizerFirst)
+        equalizer.processTile(leftChannel, rightChannel, numSamples);
+
+    for (int start = 0; start < numSamples; start += tileSize)
     {
-        float sum = 0.0f;
-        for (int ch = 0; ch < totalNumInputChannels; ++ch)
-            sum += buffer.getSample(ch, i);
-        inputSamples[i] = sum / totalNumInputChannels;
+        const int n = std::min(tileSize, numSamples - start);
+        float* left = leftChannel + start;
+        float* right = rightChannel != nullptr ? rightChannel + start : nullptr;
+
+        if (runEqualizer && ! runEqualizerFirst) equalizer.processTile(left, right, n);
+        processDynamics(left, right, n, runCompressor, runDeEsser);
     }
 
-    // Update and process EQ (first in chain - signal flow: HPF -> EQ -> Compressor -> De-Esser)
-    equalizer.setHPFFrequency(eqHPFFreq->load());
-    equalizer.setHPFSlope(static_cast<int>(eqHPFSlope->load()) == 1 ? 24 : 12);
-    equalizer.setLowShelfFrequency(eqLowShelfFreq->load());
-    equalizer.setLowShelfGain(eqLowShelfGain->load());
-    equalizer.setLowMidFrequency(eqLowMidFreq->load());
-    equalizer.setLowMidGain(eqLowMidGain->load());
-    equalizer.setLowMidQ(eqLowMidQ->load());
-    equalizer.setMidFrequency(eqMidFreq->load());
-    equalizer.setMidGain(eqMidGain->load());
-    equalizer.setMidQ(eqMidQ->load());
-    equalizer.setHighMidFrequency(eqHighMidFreq->load());
-    equalizer.setHighMidGain(eqHighMidGain->load());
-    equalizer.setHighMidQ(eqHighMidQ->load());
-    equalizer.setHighShelfFrequency(eqHighShelfFreq->load());
-    equalizer.setHighShelfGain(eqHighShelfGain->load());
-    equalizer.setBypass(eqBypass->load() > 0.5f);
-    equalizer.process(buffer);
-
-    // Update and process compressor
-    compressor.setThreshold(compThreshold->load());
-    compressor.setRatio(compRatio->load());
-    compressor.setAttack(compAttack->load());
-    compressor.setRelease(compRelease->load());
-    compressor.setMakeupGain(compMakeup->load());
-    compressor.setKnee(compKnee->load());
-    compressor.setAutoRelease(compAutoRelease->load() > 0.5f);
-    compressor.setBypass(compBypass->load() > 0.5f);
-    compressor.process(buffer);
+    if (runCompressor) compressor.endBlock();
+    if (runDeEsser)    deEsser.endBlock();
+}
 
-    // Update and process de-esser
-    deEsser.setFrequency(deessFrequency->load());
-    deEsser.setThreshold(deessThreshold->load());
-    deEsser.setRange(deessRange->load());
-    deEsser.setMode(static_cast<int>(deessMode->load()));
-    deEsser.setListenMode(deessListen->load() > 0.5f);
-    deEsser.setBypass(deessBypass->load() > 0.5f);
-    deEsser.process(buffer);
-
-    // Apply output gain
-    float outGainLinear = std::pow(10.0f, outputGain->load() / 20.0f);
-    buffer.applyGain(outGainLinear);
-
-    // Measure output level
-    float outLevel = 0.0f;
-    for (int ch = 0; ch < totalNumInputChannels; ++ch)
-        outLevel = std::max(outLevel, buffer.getMagnitude(ch, 0, buffer.getNumSamples()));
-    outputLevel.store(outLevel);
-
-    // Store output samples for FFT (mono mix of output after all processing)
-    std::vector<float> outputSamples(buffer.getNumSamples());
-    for (int i = 0; i < buffer.getNumSamples(); ++i)
+void VoxProcAudioProcessor::processDynamics(float* leftChannel, float* rightChannel, int numSamples,
+                                            bool runCompressor, bool runDeEsser)
+{
+    const int factor = oversampler.getFactor();
+
+    if (factor == 1)
     {
-        float sum = 0.0f;
-        for (int ch = 0; ch < totalNumInputChannels; ++ch)
-            sum += buffer.getSample(ch, i);
-        outputSamples[i] = sum / totalNumInputChannels;
+        if (runCompressor) compressor.processTile(leftChannel, rightChannel, numSamples);
+        if (runDeEsser)    deEsser.processTile(leftChannel, rightChannel, numSamples);
+        return;
     }
 
-    // Push samples to FFT
-    pushSamplesToFFT(inputSamples.data(), outputSamples.data(), buffer.getNumSamples());
+    // The oversampler runs even with both modules bypassed, so the latency
+    // stays the same
+    const int chunkSize = oversampler.getMaxBlockSize();
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        const int n = std::min(chunkSize, numSamples - start);
+        float* left = leftChannel + start;
+        float* right = rightChannel != nullptr ? rightChannel + start : nullptr;
+
+        oversampler.upsample(left, right, n);
+
+        float* upLeft = oversampler.getOversampledChannel(0);
+        float* upRight = right != nullptr ? oversampler.getOversampledChannel(1) : nullptr;
+
+        if (runCompressor) compressor.processTile(upLeft, upRight, n * factor);
+        if (runDeEsser)    deEsser.processTile(upLeft, upRight, n * factor);
+
+        oversampler.downsample(left, right, n);
+    }
+}
+
+float VoxProcAudioProcessor::getAlignedLookaheadMs(float lookaheadMs) const
+{
+    const double sampleRate = currentSampleRate.load();
+    return static_cast<float>(Compressor::getLookaheadSamples(lookaheadMs, sampleRate) * 1000.0 / sampleRate);
+}
+
+Equalizer::Parameters VoxProcAudioProcessor::getEqualizerParameters() const
+{
+    Equalizer::Parameters p;
+    p.hpfFreq = eqHPFFreq->load();
+    p.hpfSlope = static_cast<int>(eqHPFSlope->load()) == 1 ? 24 : 12;
+    p.lowShelfFreq = eqLowShelfFreq->load();
+    p.lowShelfGain = eqLowShelfGain->load();
+    p.lowMidFreq = eqLowMidFreq->load();
+    p.lowMidGain = eqLowMidGain->load();
+    p.lowMidQ = eqLowMidQ->load();
+    p.midFreq = eqMidFreq->load();
+    p.midGain = eqMidGain->load();
+    p.midQ = eqMidQ->load();
+    p.highMidFreq = eqHighMidFreq->load();
+    p.highMidGain = eqHighMidGain->load();
+    p.highMidQ = eqHighMidQ->load();
+    p.highShelfFreq = eqHighShelfFreq->load();
+    p.highShelfGain = eqHighShelfGain->load();
+    return p;
+}
+
+void VoxProcAudioProcessor::pushEqualizerParameters()
+{
+    const auto& p = equalizerParameters;
+
+    if (p.changed(eqHPFFreqIndex))       equalizer.setHPFFrequency(p[eqHPFFreqIndex]);
+    if (p.changed(eqHPFSlopeIndex))      equalizer.setHPFSlope(static_cast<int>(p[eqHPFSlopeIndex]) == 1 ? 24 : 12);
+    if (p.changed(eqLowShelfFreqIndex))  equalizer.setLowShelfFrequency(p[eqLowShelfFreqIndex]);
+    if (p.changed(eqLowShelfGainIndex))  equalizer.setLowShelfGain(p[eqLowShelfGainIndex]);
+    if (p.changed(eqLowMidFreqIndex))    equalizer.setLowMidFrequency(p[eqLowMidFreqIndex]);
+    if (p.changed(eqLowMidGainIndex))    equalizer.setLowMidGain(p[eqLowMidGainIndex]);
+    if (p.changed(eqLowMidQIndex))       equalizer.setLowMidQ(p[eqLowMidQIndex]);
+    if (p.changed(eqMidFreqIndex))       equalizer.setMidFrequency(p[eqMidFreqIndex]);
+    if (p.changed(eqMidGainIndex))       equalizer.setMidGain(p[eqMidGainIndex]);
+    if (p.changed(eqMidQIndex))          equalizer.setMidQ(p[eqMidQIndex]);
+    if (p.changed(eqHighMidFreqIndex))   equalizer.setHighMidFrequency(p[eqHighMidFreqIndex]);
+    if (p.changed(eqHighMidGainIndex))   equalizer.setHighMidGain(p[eqHighMidGainIndex]);
+    if (p.changed(eqHighMidQIndex))      equalizer.setHighMidQ(p[eqHighMidQIndex]);
+    if (p.changed(eqHighShelfFreqIndex)) equalizer.setHighShelfFrequency(p[eqHighShelfFreqIndex]);
+    if (p.changed(eqHighShelfGainIndex)) equalizer.setHighShelfGain(p[eqHighShelfGainIndex]);
+    if (p.changed(eqBypassIndex))        equalizer.setBypass(p[eqBypassIndex] > 0.5f);
+    if (p.changed(eqModeIndex))          equalizer.setLinearPhase(p[eqModeIndex] > 0.5f);
+}
+
+void VoxProcAudioProcessor::pushCompressorParameters()
+{
+    const auto& p = compressorParameters;
+
+    if (p.changed(compThresholdIndex))   compressor.setThreshold(p[compThresholdIndex]);
+    if (p.changed(compRatioIndex))       compressor.setRatio(p[compRatioIndex]);
+    if (p.changed(compAttackIndex))      compressor.setAttack(p[compAttackIndex]);
+    if (p.changed(compReleaseIndex))     compressor.setRelease(p[compReleaseIndex]);
+    if (p.changed(compMakeupIndex))      compressor.setMakeupGain(p[compMakeupIndex]);
+    if (p.changed(compKneeIndex))        compressor.setKnee(p[compKneeIndex]);
+    if (p.changed(compAutoReleaseIndex)) compressor.setAutoRelease(p[compAutoReleaseIndex] > 0.5f);
+    if (p.changed(compBypassIndex))      compressor.setBypass(p[compBypassIndex] > 0.5f);
+    if (p.changed(compLookaheadIndex))   compressor.setLookahead(getAlignedLookaheadMs(p[compLookaheadIndex]));
+    if (p.changed(compRMSBlendIndex))    compressor.setDetectorBlend(p[compRMSBlendIndex] * 0.01f);
+    if (p.changed(compRMSWindowIndex))   compressor.setRMSWindow(p[compRMSWindowIndex]);
+}
+
+void VoxProcAudioProcessor::pushDeEsserParameters()
+{
+    const auto& p = deEsserParameters;
+
+    if (p.changed(deessFrequencyIndex)) deEsser.setFrequency(p[deessFrequencyIndex]);
+    if (p.changed(deessThresholdIndex)) deEsser.setThreshold(p[deessThresholdIndex]);
+    if (p.changed(deessRangeIndex))     deEsser.setRange(p[deessRangeIndex]);
+    if (p.changed(deessModeIndex))      deEsser.setMode(static_cast<int>(p[deessModeIndex]));
+    if (p.changed(deessListenIndex))    deEsser.setListenMode(p[deessListenIndex] > 0.5f);
+    if (p.changed(deessBypassIndex))    deEsser.setBypass(p[deessBypassIndex] > 0.5f);
 }
 
 void VoxProcAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
@@ -371,13 +640,37 @@ juce::AudioProcessorEditor* VoxProcAudioProcessor::createEditor()
 
 bool VoxProcAudioProcessor::hasEditor() const { return true; }
 
-void VoxProcAudioProcessor::pushSamplesToFFT(const float* inputData, const float* outputData, int numSamples)
+void VoxProcAudioProcessor::runAnalyzer()
 {
-    for (int i = 0; i < numSamples; ++i)
+    if (analyzerResetPending.exchange(false))
     {
-        inputFifo[fifoIndex] = inputData[i];
-        outputFifo[fifoIndex] = outputData[i];
-        fifoIndex++;
+        analyzerFifo.finishedRead(analyzerFifo.getNumReady());
+        inputFifo.fill(0.0f);
+        outputFifo.fill(0.0f);
+        inputSpectrum.fill(0.0f);
+        outputSpectrum.fill(0.0f);
+        fifoIndex = 0;
+
+        auto& frame = spectrumFrames.getWriteBuffer();
+        frame.input.fill(-100.0f);
+        frame.output.fill(-100.0f);
+        spectrumFrames.publish();
+    }
+
+    // Collect fftSize samples at a time from the tap
+    while (analyzerFifo.getNumReady() > 0)
+    {
+        int start1, size1, start2, size2;
+        analyzerFifo.prepareToRead(fftSize - fifoIndex, start1, size1, start2, size2);
+
+        std::copy(inputRing.begin() + start1, inputRing.begin() + start1 + size1, inputFifo.begin() + fifoIndex);
+        std::copy(outputRing.begin() + start1, outputRing.begin() + start1 + size1, outputFifo.begin() + fifoIndex);
+        fifoIndex += size1;
+        std::copy(inputRing.begin() + start2, inputRing.begin() + start2 + size2, inputFifo.begin() + fifoIndex);
+        std::copy(outputRing.begin() + start2, outputRing.begin() + start2 + size2, outputFifo.begin() + fifoIndex);
+        fifoIndex += size2;
+
+        analyzerFifo.finishedRead(size1 + size2);
 
         if (fifoIndex >= fftSize)
         {
@@ -412,6 +705,12 @@ void VoxProcAudioProcessor::processFFT()
         inputSpectrum[i] = inputSpectrum[i] * smoothing + inputMag * (1.0f - smoothing);
         outputSpectrum[i] = outputSpectrum[i] * smoothing + outputMag * (1.0f - smoothing);
     }
+
+    // Hand the finished frame to the editor, already in dB
+    auto& frame = spectrumFrames.getWriteBuffer();
+    DSPUtils::fastLinearToDecibels(inputSpectrum.data(), frame.input.data(), fftSize / 2);
+    DSPUtils::fastLinearToDecibels(outputSpectrum.data(), frame.output.data(), fftSize / 2);
+    spectrumFrames.publish();
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -4,12 +4,15 @@
 #include "DSP/Compressor.h"
 #include "DSP/DeEsser.h"
 #include "DSP/Equalizer.h"
+#include "DSP/Oversampler.h"
 
 // FFT size for spectrum analyzer
 static constexpr int fftOrder = 11;  // 2^11 = 2048 samples
 static constexpr int fftSize = 1 << fftOrder;
 
-class VoxProcAudioProcessor : public juce::AudioProcessor
+class VoxProcAudioProcessor : public juce::AudioProcessor,
+                              private juce::TimeSliceClient,
+                              private juce::AsyncUpdater
 {
 public:
     VoxProcAudioProcessor();
@@ -50,38 +53,41 @@ public:
     bool isDeEsserActive() const { return deEsser.isActive(); }
     float getInputLevel() const { return inputLevel.load(); }
     float getOutputLevel() const { return outputLevel.load(); }
+    float getInputRMSLevel() const { return inputRMSLevel.load(); }
+    float getOutputRMSLevel() const { return outputRMSLevel.load(); }
 
-    // EQ visualization
-    float getEQMagnitudeAtFrequency(float freq) const { return equalizer.getMagnitudeAtFrequency(freq); }
-    float getEQBandMagnitudeAtFrequency(float freq, int bandIndex) const { return equalizer.getBandMagnitudeAtFrequency(freq, bandIndex); }
+    // EQ visualization: the latest filter design, published by the
+    // background thread. Message thread only; see Equalizer::getDisplayCoefficients().
+    const Equalizer::CoefficientSet& getEQDisplayCoefficients() { return equalizer.getDisplayCoefficients(); }
 
-    // DSP access for visualization
-    const Equalizer& getEqualizer() const { return equalizer; }
+    // Spectrum analyzer data, published by the analysis thread: smoothed bin
+    // magnitudes in dB (-100 dB floor). Call from the message thread only;
+    // the frame stays valid until the next call.
+    struct SpectrumFrame
+    {
+        SpectrumFrame()
+        {
+            input.fill(-100.0f);
+            output.fill(-100.0f);
+        }
+
+        std::array<float, fftSize / 2> input;
+        std::array<float, fftSize / 2> output;
+    };
 
-    // Update EQ parameters for visualization (call from editor timer)
-    void updateEQForVisualization()
+    const SpectrumFrame& getSpectrum()
     {
-        equalizer.setHPFFrequency(eqHPFFreq->load());
-        equalizer.setHPFSlope(static_cast<int>(eqHPFSlope->load()) == 1 ? 24 : 12);
-        equalizer.setLowShelfFrequency(eqLowShelfFreq->load());
-        equalizer.setLowShelfGain(eqLowShelfGain->load());
-        equalizer.setLowMidFrequency(eqLowMidFreq->load());
-        equalizer.setLowMidGain(eqLowMidGain->load());
-        equalizer.setLowMidQ(eqLowMidQ->load());
-        equalizer.setMidFrequency(eqMidFreq->load());
-        equalizer.setMidGain(eqMidGain->load());
-        equalizer.setMidQ(eqMidQ->load());
-        equalizer.setHighMidFrequency(eqHighMidFreq->load());
-        equalizer.setHighMidGain(eqHighMidGain->load());
-        equalizer.setHighMidQ(eqHighMidQ->load());
-        equalizer.setHighShelfFrequency(eqHighShelfFreq->load());
-        equalizer.setHighShelfGain(eqHighShelfGain->load());
+        spectrumFrames.acquire();
+        return spectrumFrames.getReadBuffer();
     }
 
-    // Spectrum analyzer data
-    const std::array<float, fftSize / 2>& getInputSpectrum() const { return inputSpectrum; }
-    const std::array<float, fftSize / 2>& getOutputSpectrum() const { return outputSpectrum; }
-    double getCurrentSampleRate() const { return currentSampleRate; }
+    double getCurrentSampleRate() const { return currentSampleRate.load(); }
+
+    // Tile size of the chain scheduler (see processChain()); 0 runs each module
+    // over the whole block in turn. Output is the same either way. For
+    // benchmarking: call before processing starts.
+    void setChainTileSize(int numSamples) { chainTileSize = std::max(0, numSamples); }
+    int getChainTileSize() const { return chainTileSize; }
 
 private:
     juce::AudioProcessorValueTreeState apvts;
@@ -92,6 +98,126 @@ private:
     DeEsser deEsser;
     Equalizer equalizer;
 
+    // The compressor and de-esser (the nonlinear part of the chain) run
+    // inside the oversampler, at its rate; the EQ stays at the base rate. The
+    // factor and filter type are set up in prepareToPlay() only, since they
+    // change the modules' sample rate and the latency.
+    Oversampler oversampler;
+    std::atomic<double> dynamicsSampleRate { 44100.0 };
+    void processDynamics(float* leftChannel, float* rightChannel, int numSamples, bool runCompressor, bool runDeEsser);
+
+    // Lookahead rounded to whole base-rate samples, so it adds a whole number
+    // of samples of latency at any oversampling factor
+    float getAlignedLookaheadMs(float lookaheadMs) const;
+
+    // Chain scheduler: runs every enabled module on one tile of the block
+    // before moving on to the next, so large blocks stay in L1 instead of
+    // being streamed through the cache once per module
+    static constexpr int defaultChainTileSize = 64;
+    int chainTileSize = defaultChainTileSize;
+    void processChain(juce::AudioBuffer<float>& buffer);
+
+    // Background thread for work that must stay off the audio thread (filter
+    // design, gain curve tables, spectrum analysis). Polls for work in
+    // useTimeSlice().
+    juce::TimeSliceThread backgroundThread { "VoxProc DSP" };
+    int useTimeSlice() override;
+
+    // Latency of the chain as the modules are running it. The audio thread
+    // publishes it after applying parameter changes and the host is told on
+    // the message thread.
+    int getModuleLatencySamples() const;
+    void publishLatency();
+    void handleAsyncUpdate() override;
+    std::atomic<int> publishedLatencySamples { 0 };
+
+    // Parameter snapshot for one DSP module: the values pushed into it last
+    // block. update() compares them with the live APVTS values and flags the
+    // ones that moved, so setters (and their coefficient math) only run for
+    // parameters that actually changed.
+    struct ParameterSnapshot
+    {
+        static constexpr int maxParameters = 32;  // Bits in changedMask
+
+        std::array<std::atomic<float>*, maxParameters> sources {};
+        std::array<float, maxParameters> values {};
+        int numParameters = 0;
+        juce::uint32 changedMask = 0;   // Bit per parameter, from the last update()
+
+        void add(std::atomic<float>* source)
+        {
+            jassert(numParameters < maxParameters);
+            sources[(size_t) numParameters++] = source;
+        }
+
+        // Forces every parameter to count as changed on the next update()
+        void invalidate()
+        {
+            values.fill(std::numeric_limits<float>::quiet_NaN());
+        }
+
+        // Returns true if any parameter of the module changed
+        bool update()
+        {
+            changedMask = 0;
+
+            for (int i = 0; i < numParameters; ++i)
+            {
+                const float value = sources[(size_t) i]->load(std::memory_order_relaxed);
+                if (value != values[(size_t) i])
+                {
+                    values[(size_t) i] = value;
+                    changedMask |= 1u << i;
+                }
+            }
+
+            return changedMask != 0;
+        }
+
+        bool changed(int index) const { return (changedMask >> index) & 1u; }
+        float operator[](int index) const { return values[(size_t) index]; }
+    };
+
+    // Snapshot layouts (order of add() in the constructor)
+    enum EqualizerParameter
+    {
+        eqHPFFreqIndex = 0, eqHPFSlopeIndex, eqLowShelfFreqIndex, eqLowShelfGainIndex,
+        eqLowMidFreqIndex, eqLowMidGainIndex, eqLowMidQIndex, eqMidFreqIndex, eqMidGainIndex, eqMidQIndex,
+        eqHighMidFreqIndex, eqHighMidGainIndex, eqHighMidQIndex, eqHighShelfFreqIndex, eqHighShelfGainIndex,
+        eqBypassIndex, eqModeIndex
+    };
+
+    enum CompressorParameter
+    {
+        compThresholdIndex = 0, compRatioIndex, compAttackIndex, compReleaseIndex, compMakeupIndex,
+        compKneeIndex, compAutoReleaseIndex, compBypassIndex, compLookaheadIndex,
+        compRMSBlendIndex, compRMSWindowIndex
+    };
+
+    enum DeEsserParameter
+    {
+        deessFrequencyIndex = 0, deessThresholdIndex, deessRangeIndex, deessModeIndex, deessListenIndex,
+        deessBypassIndex
+    };
+
+    enum GlobalParameter { inputGainIndex = 0, outputGainIndex };
+
+    ParameterSnapshot equalizerParameters;
+    ParameterSnapshot compressorParameters;
+    ParameterSnapshot deEsserParameters;
+    ParameterSnapshot globalParameters;
+
+    Equalizer::Parameters getEqualizerParameters() const;  // Live APVTS values
+
+    void pushEqualizerParameters();
+    void pushCompressorParameters();
+    void pushDeEsserParameters();
+
+    // Input/output gain, ramped per sample to the parameter values
+    static constexpr double gainRampSeconds = 0.02;
+    DSPUtils::GainRamp inputGainRamp;
+    DSPUtils::GainRamp outputGainRamp;
+
     // === COMPRESSOR PARAMETERS ===
     std::atomic<float>* compThreshold = nullptr;
     std::atomic<float>* compRatio = nullptr;
@@ -101,6 +227,9 @@ private:
     std::atomic<float>* compKnee = nullptr;
     std::atomic<float>* compAutoRelease = nullptr;
     std::atomic<float>* compBypass = nullptr;
+    std::atomic<float>* compLookahead = nullptr;
+    std::atomic<float>* compRMSBlend = nullptr;
+    std::atomic<float>* compRMSWindow = nullptr;
 
     // === DE-ESSER PARAMETERS ===
     std::atomic<float>* deessFrequency = nullptr;
@@ -139,16 +268,33 @@ private:
     std::atomic<float>* eqHighShelfGain = nullptr;
 
     std::atomic<float>* eqBypass = nullptr;
+    std::atomic<float>* eqMode = nullptr;
 
     // === GLOBAL PARAMETERS ===
     std::atomic<float>* inputGain = nullptr;
     std::atomic<float>* outputGain = nullptr;
+    std::atomic<float>* oversampling = nullptr;        // Read in prepareToPlay() only
+    std::atomic<float>* oversamplingFilter = nullptr;  // Read in prepareToPlay() only
 
-    // Level metering
+    // Level metering (loudest channel of the last block)
     std::atomic<float> inputLevel { 0.0f };
     std::atomic<float> outputLevel { 0.0f };
-
-    // FFT for spectrum analyzer
+    std::atomic<float> inputRMSLevel { 0.0f };
+    std::atomic<float> outputRMSLevel { 0.0f };
+
+    // Spectrum analyzer. The audio thread's input/output stages write their
+    // mono mixes straight into a wait-free ring; windowing, FFT and smoothing
+    // run on the background thread, which publishes finished frames for the
+    // editor.
+    static constexpr int analyzerRingSize = fftSize * 8;
+    juce::AbstractFifo analyzerFifo { analyzerRingSize };
+    std::array<float, analyzerRingSize> inputRing {};
+    std::array<float, analyzerRingSize> outputRing {};
+    std::atomic<bool> analyzerResetPending { false };
+
+    DSPUtils::TripleBuffer<SpectrumFrame> spectrumFrames;
+
+    // Analysis thread state
     juce::dsp::FFT fft { fftOrder };
     juce::dsp::WindowingFunction<float> window { fftSize, juce::dsp::WindowingFunction<float>::hann };
 
@@ -160,11 +306,10 @@ private:
     std::array<float, fftSize> inputFifo {};
     std::array<float, fftSize> outputFifo {};
     int fifoIndex = 0;
-    bool fftDataReady = false;
 
-    double currentSampleRate = 44100.0;
+    std::atomic<double> currentSampleRate { 44100.0 };
 
-    void pushSamplesToFFT(const float* inputData, const float* outputData, int numSamples);
+    void runAnalyzer();
     void processFFT();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VoxProcAudioProcessor)
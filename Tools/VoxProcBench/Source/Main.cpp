@@ -0,0 +1,789 @@
+// VoxProcBench - DSP microbenchmarks
+//
+// Times Compressor::process, DeEsser::process and Equalizer::process on their own
+// and the full VoxProcAudioProcessor::processBlock chain, sweeping block size,
+// sample rate, channel count and the active processing modes.
+//
+// Results are written as CSV (one row per case) with ns/sample, cycles/sample and
+// block time percentiles. Cycle counts come from the TSC on x86 (reference cycles,
+// not core cycles) and are left empty on other architectures. Approximate modes
+// (the compressor's control-rate gain computer) also report their peak error
+// against the exact mode in dBFS. The chain runs both module-by-module over
+// whole blocks and through the tiled scheduler at several tile sizes; the tiled
+// rows report their difference from the untiled output (expected: none).
+// Oversampling is timed on its own (up- and downsampling with nothing in
+// between) and as part of the chain.
+//
+// With --rt-check it instead runs processBlock under allocation/mutex hooks (see
+// RealtimeCheck.h) across the same formats and several settings, and exits with
+// an error if the audio thread allocated, freed or locked anything.
+//
+// Usage:
+//   VoxProcBench [--module eq|deesser|comp|os|chain|all] [--block N] [--rate N]
+//                [--channels 1|2] [--seconds S] [--out results.csv] [--rt-check]
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "RealtimeCheck.h"
+
+#include <fstream>
+#include <limits>
+
+#if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+ #if defined (_MSC_VER)
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+ #define VOXPROC_BENCH_HAS_TSC 1
+#else
+ #define VOXPROC_BENCH_HAS_TSC 0
+#endif
+
+namespace
+{
+    constexpr int allBlockSizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+    constexpr double allSampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 };
+    constexpr int allChannelCounts[] = { 1, 2 };
+
+    inline juce::uint64 readCycleCounter()
+    {
+       #if VOXPROC_BENCH_HAS_TSC
+        return static_cast<juce::uint64>(__rdtsc());
+       #else
+        return 0;
+       #endif
+    }
+
+    struct BenchOptions
+    {
+        juce::String module = "all";
+        int blockSize = 0;          // 0 = sweep
+        double sampleRate = 0.0;    // 0 = sweep
+        int numChannels = 0;        // 0 = sweep
+        double secondsPerCase = 2.0;
+        juce::File outputFile;
+        bool realtimeCheck = false;
+    };
+
+    struct CaseConfig
+    {
+        juce::String module;
+        juce::String mode;
+        double sampleRate;
+        int blockSize;
+        int numChannels;
+    };
+
+    struct CaseResult
+    {
+        double nsPerSample = 0.0;
+        double cyclesPerSample = 0.0;
+        double meanBlockUs = 0.0;
+        double p50BlockUs = 0.0;
+        double p99BlockUs = 0.0;
+        double maxBlockUs = 0.0;
+        double realtimeMultiple = 0.0;
+        double maxErrorDb = std::numeric_limits<double>::quiet_NaN();  // vs. reference, where there is one
+    };
+
+    //==========================================================================
+    // Test signal: a vowel-like harmonic tone with bursts of high-passed noise
+    // (sibilance) and a slow level envelope, so the dynamics modules actually work
+    //==========================================================================
+    void fillTestSignal(juce::AudioBuffer<float>& signal, double sampleRate)
+    {
+        juce::Random random(0x566f78);
+        const int numSamples = signal.getNumSamples();
+        const float twoPi = juce::MathConstants<float>::twoPi;
+
+        float phase = 0.0f;
+        float noiseState = 0.0f;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float t = static_cast<float>(i / sampleRate);
+
+            // Syllable-rate envelope between roughly -30 and -6 dBFS
+            const float envelope = 0.03f + 0.47f * (0.5f + 0.5f * std::sin(twoPi * 3.0f * t));
+
+            phase += twoPi * 180.0f / static_cast<float>(sampleRate);
+            if (phase > twoPi)
+                phase -= twoPi;
+
+            float voiced = 0.0f;
+            for (int harmonic = 1; harmonic <= 8; ++harmonic)
+                voiced += std::sin(phase * static_cast<float>(harmonic)) / static_cast<float>(harmonic);
+
+            // Sibilant bursts: high-passed noise gated on for ~80 ms every 500 ms
+            const float white = random.nextFloat() * 2.0f - 1.0f;
+            const float hissy = white - noiseState;
+            noiseState = white;
+            const bool sibilant = std::fmod(t, 0.5f) < 0.08f;
+
+            const float sample = envelope * (0.5f * voiced + (sibilant ? 0.6f : 0.02f) * hissy);
+
+            for (int ch = 0; ch < signal.getNumChannels(); ++ch)
+                signal.setSample(ch, i, ch == 0 ? sample : sample * 0.9f);
+        }
+    }
+
+    //==========================================================================
+    // Runs one case: processes secondsPerCase of the test signal in blocks and
+    // records the time of every block
+    //==========================================================================
+    CaseResult runCase(const CaseConfig& config, double secondsPerCase,
+                       const std::function<void(juce::AudioBuffer<float>&)>& process)
+    {
+        juce::AudioBuffer<float> source(config.numChannels, static_cast<int>(config.sampleRate));
+        fillTestSignal(source, config.sampleRate);
+
+        juce::AudioBuffer<float> block(config.numChannels, config.blockSize);
+
+        const int sourceLength = source.getNumSamples();
+        const int warmupBlocks = juce::jmax(8, static_cast<int>(0.1 * config.sampleRate) / config.blockSize);
+        const int numBlocks = juce::jmax(32, static_cast<int>(secondsPerCase * config.sampleRate) / config.blockSize);
+
+        std::vector<double> blockSeconds;
+        blockSeconds.reserve(static_cast<size_t>(numBlocks));
+
+        int readPosition = 0;
+        juce::int64 totalTicks = 0;
+        juce::uint64 totalCycles = 0;
+
+        for (int b = 0; b < warmupBlocks + numBlocks; ++b)
+        {
+            // Copy in the next slice of the looped test signal (not timed)
+            for (int ch = 0; ch < config.numChannels; ++ch)
+            {
+                int written = 0;
+                int pos = readPosition;
+                while (written < config.blockSize)
+                {
+                    const int num = juce::jmin(config.blockSize - written, sourceLength - pos);
+                    block.copyFrom(ch, written, source, ch, pos, num);
+                    written += num;
+                    pos = (pos + num) % sourceLength;
+                }
+            }
+            readPosition = (readPosition + config.blockSize) % sourceLength;
+
+            const auto startCycles = readCycleCounter();
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            process(block);
+            const auto endTicks = juce::Time::getHighResolutionTicks();
+            const auto endCycles = readCycleCounter();
+
+            if (b < warmupBlocks)
+                continue;
+
+            totalTicks += endTicks - startTicks;
+            totalCycles += endCycles - startCycles;
+            blockSeconds.push_back(juce::Time::highResolutionTicksToSeconds(endTicks - startTicks));
+        }
+
+        const double totalSamples = static_cast<double>(numBlocks) * config.blockSize;
+        const double totalSeconds = juce::Time::highResolutionTicksToSeconds(totalTicks);
+
+        std::sort(blockSeconds.begin(), blockSeconds.end());
+        auto percentile = [&blockSeconds](double p)
+        {
+            const auto index = static_cast<size_t>(std::ceil(p * static_cast<double>(blockSeconds.size()))) - 1;
+            return blockSeconds[juce::jlimit<size_t>(0, blockSeconds.size() - 1, index)];
+        };
+
+        CaseResult result;
+        result.nsPerSample = totalSeconds * 1.0e9 / totalSamples;
+        result.cyclesPerSample = VOXPROC_BENCH_HAS_TSC ? static_cast<double>(totalCycles) / totalSamples : 0.0;
+        result.meanBlockUs = totalSeconds * 1.0e6 / numBlocks;
+        result.p50BlockUs = percentile(0.50) * 1.0e6;
+        result.p99BlockUs = percentile(0.99) * 1.0e6;
+        result.maxBlockUs = blockSeconds.back() * 1.0e6;
+        result.realtimeMultiple = totalSeconds > 0.0 ? (totalSamples / config.sampleRate) / totalSeconds : 0.0;
+        return result;
+    }
+
+    //==========================================================================
+    // CSV output
+    //==========================================================================
+    class CsvWriter
+    {
+    public:
+        explicit CsvWriter(std::ostream& s) : stream(s)
+        {
+            stream << "module,mode,sample_rate,block_size,channels,ns_per_sample,cycles_per_sample,"
+                      "mean_block_us,p50_block_us,p99_block_us,max_block_us,realtime_multiple,max_error_db\n";
+        }
+
+        void write(const CaseConfig& config, const CaseResult& result)
+        {
+            stream << config.module << ',' << config.mode << ','
+                   << static_cast<int>(config.sampleRate) << ',' << config.blockSize << ',' << config.numChannels << ','
+                   << juce::String(result.nsPerSample, 3) << ','
+                   << (VOXPROC_BENCH_HAS_TSC ? juce::String(result.cyclesPerSample, 3) : juce::String()) << ','
+                   << juce::String(result.meanBlockUs, 3) << ','
+                   << juce::String(result.p50BlockUs, 3) << ','
+                   << juce::String(result.p99BlockUs, 3) << ','
+                   << juce::String(result.maxBlockUs, 3) << ','
+                   << juce::String(result.realtimeMultiple, 1) << ','
+                   << (std::isnan(result.maxErrorDb) ? juce::String() : juce::String(result.maxErrorDb, 1)) << '\n';
+            stream.flush();
+        }
+
+    private:
+        std::ostream& stream;
+    };
+
+    //==========================================================================
+    // Module set-ups
+    //==========================================================================
+    void configureEqualizer(Equalizer& eq, int hpfSlope)
+    {
+        // Typical lead vocal curve (USAGE.md): HPF plus all five bands active
+        eq.setHPFFrequency(100.0f);
+        eq.setHPFSlope(hpfSlope);
+        eq.setLowShelfFrequency(200.0f);
+        eq.setLowShelfGain(-2.0f);
+        eq.setLowMidFrequency(400.0f);
+        eq.setLowMidGain(-2.0f);
+        eq.setLowMidQ(1.5f);
+        eq.setMidFrequency(2800.0f);
+        eq.setMidGain(2.0f);
+        eq.setMidQ(1.0f);
+        eq.setHighMidFrequency(5000.0f);
+        eq.setHighMidGain(1.0f);
+        eq.setHighMidQ(1.0f);
+        eq.setHighShelfFrequency(10000.0f);
+        eq.setHighShelfGain(2.0f);
+    }
+
+    void configureDeEsser(DeEsser& deEsser, int mode, bool listen)
+    {
+        deEsser.setFrequency(6000.0f);
+        deEsser.setThreshold(-30.0f);
+        deEsser.setRange(6.0f);
+        deEsser.setMode(mode);
+        deEsser.setListenMode(listen);
+    }
+
+    void configureCompressor(Compressor& compressor, float kneeDb)
+    {
+        compressor.setThreshold(-18.0f);
+        compressor.setRatio(4.0f);
+        compressor.setAttack(10.0f);
+        compressor.setRelease(100.0f);
+        compressor.setMakeupGain(3.0f);
+        compressor.setKnee(kneeDb);
+    }
+
+    //==========================================================================
+    // Quality of the control-rate gain computer: peak difference from the
+    // audio-rate compressor on the same signal, in dB relative to full scale
+    //==========================================================================
+    double measureControlRateError(const CaseConfig& config, float kneeDb, int controlInterval)
+    {
+        juce::AudioBuffer<float> reference(config.numChannels, static_cast<int>(config.sampleRate));
+        fillTestSignal(reference, config.sampleRate);
+        juce::AudioBuffer<float> test(reference);
+
+        Compressor audioRate, controlRate;
+        configureCompressor(audioRate, kneeDb);
+        configureCompressor(controlRate, kneeDb);
+        controlRate.setControlInterval(controlInterval);
+        audioRate.prepare(config.sampleRate, config.blockSize);
+        controlRate.prepare(config.sampleRate, config.blockSize);
+
+        const int numSamples = reference.getNumSamples();
+        for (int start = 0; start < numSamples; start += config.blockSize)
+        {
+            const int num = juce::jmin(config.blockSize, numSamples - start);
+            juce::AudioBuffer<float> referenceBlock(reference.getArrayOfWritePointers(), config.numChannels, start, num);
+            juce::AudioBuffer<float> testBlock(test.getArrayOfWritePointers(), config.numChannels, start, num);
+            audioRate.process(referenceBlock);
+            controlRate.process(testBlock);
+        }
+
+        float peakError = 0.0f;
+        for (int ch = 0; ch < config.numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                peakError = juce::jmax(peakError, std::abs(test.getSample(ch, i) - reference.getSample(ch, i)));
+
+        return juce::Decibels::gainToDecibels(peakError, -200.0f);
+    }
+
+    void setParameter(VoxProcAudioProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* param = processor.getAPVTS().getParameter(id))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    void configureChain(VoxProcAudioProcessor& processor)
+    {
+        // Modern rock lead vocal settings from USAGE.md
+        setParameter(processor, "eqHPFFreq", 100.0f);
+        setParameter(processor, "eqHPFSlope", 1.0f);
+        setParameter(processor, "eqLowShelfFreq", 200.0f);
+        setParameter(processor, "eqLowShelfGain", -2.0f);
+        setParameter(processor, "eqLowMidFreq", 400.0f);
+        setParameter(processor, "eqLowMidGain", -2.0f);
+        setParameter(processor, "eqLowMidQ", 1.5f);
+        setParameter(processor, "eqMidFreq", 2800.0f);
+        setParameter(processor, "eqMidGain", 2.0f);
+        setParameter(processor, "eqHighMidFreq", 5000.0f);
+        setParameter(processor, "eqHighMidGain", 1.0f);
+        setParameter(processor, "eqHighShelfFreq", 10000.0f);
+        setParameter(processor, "eqHighShelfGain", 2.0f);
+
+        setParameter(processor, "compThreshold", -18.0f);
+        setParameter(processor, "compRatio", 4.0f);
+        setParameter(processor, "compAttack", 10.0f);
+        setParameter(processor, "compRelease", 100.0f);
+        setParameter(processor, "compKnee", 6.0f);
+        setParameter(processor, "compMakeup", 3.0f);
+
+        setParameter(processor, "deessFrequency", 6000.0f);
+        setParameter(processor, "deessThreshold", -18.0f);
+        setParameter(processor, "deessRange", 6.0f);
+    }
+
+    //==========================================================================
+    // Sweeps
+    //==========================================================================
+    template <typename Fn>
+    void forEachFormat(const BenchOptions& options, Fn&& fn)
+    {
+        for (double sampleRate : allSampleRates)
+        {
+            if (options.sampleRate > 0.0 && ! juce::approximatelyEqual(sampleRate, options.sampleRate))
+                continue;
+
+            for (int blockSize : allBlockSizes)
+            {
+                if (options.blockSize > 0 && blockSize != options.blockSize)
+                    continue;
+
+                for (int numChannels : allChannelCounts)
+                {
+                    if (options.numChannels > 0 && numChannels != options.numChannels)
+                        continue;
+
+                    fn(sampleRate, blockSize, numChannels);
+                }
+            }
+        }
+    }
+
+    void benchEqualizer(const BenchOptions& options, CsvWriter& csv)
+    {
+        for (int slope : { 12, 24 })
+        {
+            forEachFormat(options, [&](double sampleRate, int blockSize, int numChannels)
+            {
+                Equalizer eq;
+                configureEqualizer(eq, slope);
+                eq.prepare(sampleRate, blockSize);
+
+                CaseConfig config { "eq", "hpf" + juce::String(slope), sampleRate, blockSize, numChannels };
+                csv.write(config, runCase(config, options.secondsPerCase, [&](auto& buffer) { eq.process(buffer); }));
+            });
+        }
+    }
+
+    void benchDeEsser(const BenchOptions& options, CsvWriter& csv)
+    {
+        struct Mode { const char* name; int mode; bool listen; };
+        const Mode modes[] = { { "splitband", DeEsser::SplitBand, false },
+                               { "wideband", DeEsser::Wideband, false },
+                               { "listen", DeEsser::SplitBand, true } };
+
+        for (const auto& mode : modes)
+        {
+            forEachFormat(options, [&](double sampleRate, int blockSize, int numChannels)
+            {
+                DeEsser deEsser;
+                configureDeEsser(deEsser, mode.mode, mode.listen);
+                deEsser.prepare(sampleRate, blockSize);
+
+                CaseConfig config { "deesser", mode.name, sampleRate, blockSize, numChannels };
+                csv.write(config, runCase(config, options.secondsPerCase, [&](auto& buffer) { deEsser.process(buffer); }));
+            });
+        }
+    }
+
+    void benchCompressor(const BenchOptions& options, CsvWriter& csv)
+    {
+        // Audio-rate gain computer, then control rate every 8/16/32 samples
+        for (float knee : { 0.0f, 6.0f })
+        {
+            for (int controlInterval : { 1, 8, 16, 32 })
+            {
+                forEachFormat(options, [&](double sampleRate, int blockSize, int numChannels)
+                {
+                    Compressor compressor;
+                    configureCompressor(compressor, knee);
+                    compressor.setControlInterval(controlInterval);
+                    compressor.prepare(sampleRate, blockSize);
+
+                    juce::String mode = knee > 0.0f ? "softknee" : "hardknee";
+                    if (controlInterval > 1)
+                        mode << "-cr" << controlInterval;
+
+                    CaseConfig config { "comp", mode, sampleRate, blockSize, numChannels };
+                    auto result = runCase(config, options.secondsPerCase, [&](auto& buffer) { compressor.process(buffer); });
+
+                    if (controlInterval > 1)
+                        result.maxErrorDb = measureControlRateError(config, knee, controlInterval);
+
+                    csv.write(config, result);
+                });
+            }
+        }
+
+        // Detector options: RMS (half and fully blended) and lookahead
+        struct DetectorMode
+        {
+            const char* name;
+            float rmsBlend;
+            float lookaheadMs;
+        };
+
+        for (const auto& detector : { DetectorMode { "rms50", 0.5f, 0.0f }, DetectorMode { "rms100", 1.0f, 0.0f },
+                                      DetectorMode { "lookahead5", 0.0f, 5.0f } })
+        {
+            forEachFormat(options, [&](double sampleRate, int blockSize, int numChannels)
+            {
+                Compressor compressor;
+                configureCompressor(compressor, 6.0f);
+                compressor.setDetectorBlend(detector.rmsBlend);
+                compressor.setLookahead(detector.lookaheadMs);
+                compressor.prepare(sampleRate, blockSize);
+
+                CaseConfig config { "comp", detector.name, sampleRate, blockSize, numChannels };
+                csv.write(config, runCase(config, options.secondsPerCase, [&](auto& buffer) { compressor.process(buffer); }));
+            });
+        }
+    }
+
+    void benchOversampler(const BenchOptions& options, CsvWriter& csv)
+    {
+        for (auto filterType : { Oversampler::LinearPhase, Oversampler::MinimumPhase })
+        {
+            for (int factorLog2 = 1; factorLog2 <= Oversampler::maxFactorLog2; ++factorLog2)
+            {
+                forEachFormat(options, [&](double sampleRate, int blockSize, int numChannels)
+                {
+                    Oversampler oversampler;
+                    oversampler.prepare(factorLog2, filterType, blockSize);
+
+                    const juce::String mode = juce::String(1 << factorLog2) + "x-"
+                                            + (filterType == Oversampler::LinearPhase ? "linear" : "minphase");
+
+                    CaseConfig config { "os", mode, sampleRate, blockSize, numChannels };
+                    csv.write(config, runCase(config, options.secondsPerCase, [&](auto& buffer)
+                    {
+                        float* left = buffer.getWritePointer(0);
+                        float* right = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : nullptr;
+                        oversampler.upsample(left, right, buffer.getNumSamples());
+                        oversampler.downsample(left, right, buffer.getNumSamples());
+                    }));
+                });
+            }
+        }
+    }
+
+    void prepareChain(VoxProcAudioProcessor& processor, double sampleRate, int blockSize, int numChannels, int tileSize)
+    {
+        const auto channelSet = numChannels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channelSet);
+        layout.outputBuses.add(channelSet);
+        processor.setBusesLayout(layout);
+
+        configureChain(processor);
+        processor.setChainTileSize(tileSize);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+
+    //==========================================================================
+    // Tiled chain vs. module-by-module over whole blocks: peak difference in
+    // dBFS (-200 when the outputs are identical, as they should be)
+    //==========================================================================
+    double measureTiledChainError(const CaseConfig& config, int tileSize)
+    {
+        juce::AudioBuffer<float> reference(config.numChannels, static_cast<int>(config.sampleRate));
+        fillTestSignal(reference, config.sampleRate);
+        juce::AudioBuffer<float> test(reference);
+
+        // Offline mode, so neither depends on when the background thread
+        // publishes a design
+        VoxProcAudioProcessor untiled, tiled;
+        untiled.setNonRealtime(true);
+        tiled.setNonRealtime(true);
+        prepareChain(untiled, config.sampleRate, config.blockSize, config.numChannels, 0);
+        prepareChain(tiled, config.sampleRate, config.blockSize, config.numChannels, tileSize);
+
+        juce::MidiBuffer midi;
+        const int numSamples = reference.getNumSamples();
+        for (int start = 0; start < numSamples; start += config.blockSize)
+        {
+            const int num = juce::jmin(config.blockSize, numSamples - start);
+            juce::AudioBuffer<float> referenceBlock(reference.getArrayOfWritePointers(), config.numChannels, start, num);
+            juce::AudioBuffer<float> testBlock(test.getArrayOfWritePointers(), config.numChannels, start, num);
+            untiled.processBlock(referenceBlock, midi);
+            tiled.processBlock(testBlock, midi);
+        }
+
+        float peakError = 0.0f;
+        for (int ch = 0; ch < config.numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                peakError = juce::jmax(peakError, std::abs(test.getSample(ch, i) - reference.getSample(ch, i)));
+
+        return juce::Decibels::gainToDecibels(peakError, -200.0f);
+    }
+
+    void benchChain(const BenchOptions& options, CsvWriter& csv)
+    {
+        // Module-by-module over the whole block, then the tiled scheduler
+        for (int tileSize : { 0, 32, 64, 128 })
+        {
+            forEachFormat(options, [&](double sampleRate, int blockSize, int numChannels)
+            {
+                VoxProcAudioProcessor processor;
+                prepareChain(processor, sampleRate, blockSize, numChannels, tileSize);
+
+                const juce::String mode = tileSize > 0 ? "processBlock-tile" + juce::String(tileSize) : "processBlock-untiled";
+
+                juce::MidiBuffer midi;
+                CaseConfig config { "chain", mode, sampleRate, blockSize, numChannels };
+                auto result = runCase(config, options.secondsPerCase, [&](auto& buffer) { processor.processBlock(buffer, midi); });
+
+                if (tileSize > 0)
+                    result.maxErrorDb = measureTiledChainError(config, tileSize);
+
+                csv.write(config, result);
+                processor.releaseResources();
+            });
+        }
+
+        // Compressor and de-esser oversampled (linear phase, default tile size)
+        for (int factorLog2 = 1; factorLog2 <= Oversampler::maxFactorLog2; ++factorLog2)
+        {
+            forEachFormat(options, [&](double sampleRate, int blockSize, int numChannels)
+            {
+                VoxProcAudioProcessor processor;
+                setParameter(processor, "oversampling", static_cast<float>(factorLog2));
+                prepareChain(processor, sampleRate, blockSize, numChannels, 64);
+
+                juce::MidiBuffer midi;
+                CaseConfig config { "chain", "processBlock-os" + juce::String(1 << factorLog2) + "x", sampleRate, blockSize, numChannels };
+                csv.write(config, runCase(config, options.secondsPerCase, [&](auto& buffer) { processor.processBlock(buffer, midi); }));
+                processor.releaseResources();
+            });
+        }
+
+        // Linear-phase EQ (partitioned convolution, one partition per block)
+        forEachFormat(options, [&](double sampleRate, int blockSize, int numChannels)
+        {
+            VoxProcAudioProcessor processor;
+            setParameter(processor, "eqMode", 1.0f);
+            prepareChain(processor, sampleRate, blockSize, numChannels, 64);
+
+            juce::MidiBuffer midi;
+            CaseConfig config { "chain", "processBlock-eqlinear", sampleRate, blockSize, numChannels };
+            csv.write(config, runCase(config, options.secondsPerCase, [&](auto& buffer) { processor.processBlock(buffer, midi); }));
+            processor.releaseResources();
+        });
+    }
+
+    //==========================================================================
+    // Real-time safety check: processBlock runs inside a ScopedRealtimeSection
+    // for every scenario, with shorter blocks mixed in and a parameter change
+    // halfway through (set from outside the section, as a host would)
+    //==========================================================================
+    bool runRealtimeCheck(const BenchOptions& options, std::ostream& out)
+    {
+        struct Scenario
+        {
+            const char* name;
+            std::function<void(VoxProcAudioProcessor&)> configure;
+        };
+
+        const Scenario scenarios[] = {
+            { "defaults",        [](VoxProcAudioProcessor&) {} },
+            { "vocal-chain",     [](VoxProcAudioProcessor& p) { configureChain(p); } },
+            { "wideband-listen", [](VoxProcAudioProcessor& p) { configureChain(p); setParameter(p, "deessMode", 1.0f);
+                                                                setParameter(p, "deessListen", 1.0f); } },
+            { "auto-release",    [](VoxProcAudioProcessor& p) { configureChain(p); setParameter(p, "compAutoRelease", 1.0f); } },
+            { "rms-lookahead",   [](VoxProcAudioProcessor& p) { configureChain(p); setParameter(p, "compRMSBlend", 50.0f);
+                                                                setParameter(p, "compLookahead", 5.0f); } },
+            { "oversampled-8x",  [](VoxProcAudioProcessor& p) { configureChain(p); setParameter(p, "oversampling", 3.0f); } },
+            { "minphase-4x",     [](VoxProcAudioProcessor& p) { configureChain(p); setParameter(p, "oversampling", 2.0f);
+                                                                setParameter(p, "oversamplingFilter", 1.0f);
+                                                                setParameter(p, "compLookahead", 5.0f); } },
+            { "linear-phase-eq", [](VoxProcAudioProcessor& p) { configureChain(p); setParameter(p, "eqMode", 1.0f); } },
+            { "bypassed",        [](VoxProcAudioProcessor& p) { setParameter(p, "eqBypass", 1.0f); setParameter(p, "compBypass", 1.0f);
+                                                                setParameter(p, "deessBypass", 1.0f); } }
+        };
+
+        if (! RealtimeCheck::hooksCAllocatorAndMutexes())
+            std::cerr << "Note: only operator new/delete are hooked on this platform" << std::endl;
+
+        out << "scenario,sample_rate,block_size,channels,allocations,deallocations,mutex_locks,result\n";
+        bool passed = true;
+
+        forEachFormat(options, [&](double sampleRate, int blockSize, int numChannels)
+        {
+            for (const auto& scenario : scenarios)
+            {
+                VoxProcAudioProcessor processor;
+
+                const auto channelSet = numChannels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+                juce::AudioProcessor::BusesLayout layout;
+                layout.inputBuses.add(channelSet);
+                layout.outputBuses.add(channelSet);
+                processor.setBusesLayout(layout);
+
+                scenario.configure(processor);
+                processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+                processor.prepareToPlay(sampleRate, blockSize);
+
+                juce::AudioBuffer<float> source(numChannels, static_cast<int>(sampleRate));
+                fillTestSignal(source, sampleRate);
+
+                juce::AudioBuffer<float> block(numChannels, blockSize);
+                juce::MidiBuffer midi;
+
+                const int numBlocks = juce::jmax(16, static_cast<int>(0.5 * sampleRate) / blockSize);
+                int readPosition = 0;
+
+                RealtimeCheck::resetViolations();
+
+                for (int b = 0; b < numBlocks; ++b)
+                {
+                    // Every third block is shorter than the prepared size
+                    const int numThisTime = b % 3 == 2 ? blockSize / 2 + 1 : blockSize;
+                    if (readPosition + numThisTime > source.getNumSamples())
+                        readPosition = 0;
+
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        block.copyFrom(ch, 0, source, ch, readPosition, numThisTime);
+                    readPosition += numThisTime;
+
+                    if (b == numBlocks / 2)
+                    {
+                        setParameter(processor, "compThreshold", -30.0f);
+                        setParameter(processor, "deessFrequency", 7500.0f);
+                        setParameter(processor, "eqMidGain", -4.0f);
+                    }
+
+                    juce::AudioBuffer<float> view(block.getArrayOfWritePointers(), numChannels, numThisTime);
+
+                    RealtimeCheck::ScopedRealtimeSection realtimeSection;
+                    processor.processBlock(view, midi);
+                }
+
+                const auto violations = RealtimeCheck::getViolations();
+                passed = passed && ! violations.any();
+
+                out << scenario.name << ',' << static_cast<int>(sampleRate) << ',' << blockSize << ',' << numChannels << ','
+                    << violations.allocations << ',' << violations.deallocations << ',' << violations.mutexLocks << ','
+                    << (violations.any() ? "FAIL" : "PASS") << '\n';
+                out.flush();
+
+                processor.releaseResources();
+            }
+        });
+
+        return passed;
+    }
+
+    void printUsage()
+    {
+        std::cout << "Usage: VoxProcBench [--module eq|deesser|comp|os|chain|all] [--block N] [--rate N]\n"
+                     "                    [--channels 1|2] [--seconds S] [--out results.csv] [--rt-check]" << std::endl;
+    }
+
+    bool parseArguments(const juce::StringArray& args, BenchOptions& options)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+
+            if (arg == "--rt-check")
+            {
+                options.realtimeCheck = true;
+                continue;
+            }
+
+            if (i + 1 >= args.size())
+                return false;
+
+            if (arg == "--module")
+                options.module = args[++i];
+            else if (arg == "--block")
+                options.blockSize = args[++i].getIntValue();
+            else if (arg == "--rate")
+                options.sampleRate = args[++i].getDoubleValue();
+            else if (arg == "--channels")
+                options.numChannels = args[++i].getIntValue();
+            else if (arg == "--seconds")
+                options.secondsPerCase = args[++i].getDoubleValue();
+            else if (arg == "--out")
+                options.outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+            else
+                return false;
+        }
+
+        const juce::StringArray modules { "eq", "deesser", "comp", "os", "chain", "all" };
+        return modules.contains(options.module) && options.secondsPerCase > 0.0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ScopedNoDenormals noDenormals;
+
+    BenchOptions options;
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::String::fromUTF8(argv[i]));
+
+    if (! parseArguments(args, options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::ofstream fileStream;
+    if (options.outputFile != juce::File())
+    {
+        fileStream.open(options.outputFile.getFullPathName().toStdString());
+        if (! fileStream)
+        {
+            std::cerr << "Could not create " << options.outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    std::ostream& out = fileStream.is_open() ? static_cast<std::ostream&>(fileStream) : std::cout;
+
+    if (options.realtimeCheck)
+    {
+        const bool passed = runRealtimeCheck(options, out);
+        std::cerr << (passed ? "Real-time check passed" : "Real-time check FAILED: processBlock allocated or locked") << std::endl;
+        return passed ? 0 : 1;
+    }
+
+    CsvWriter csv(out);
+
+    const bool all = options.module == "all";
+    if (all || options.module == "eq")      benchEqualizer(options, csv);
+    if (all || options.module == "deesser") benchDeEsser(options, csv);
+    if (all || options.module == "comp")    benchCompressor(options, csv);
+    if (all || options.module == "os")      benchOversampler(options, csv);
+    if (all || options.module == "chain")   benchChain(options, csv);
+
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include "RealtimeCheck.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#if defined (__linux__) && defined (__GLIBC__)
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #define VOXPROC_RTCHECK_INTERPOSE 1
+
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void __libc_free(void*);
+}
+#else
+ #define VOXPROC_RTCHECK_INTERPOSE 0
+#endif
+
+namespace
+{
+    // Plain thread_local PODs: constant-initialised, so touching them from
+    // inside malloc never allocates
+    thread_local int sectionDepth = 0;
+    thread_local RealtimeCheck::Violations violations;
+
+    inline void noteAllocation()   { if (sectionDepth > 0) ++violations.allocations; }
+    inline void noteDeallocation() { if (sectionDepth > 0) ++violations.deallocations; }
+
+    // The underlying allocator, bypassing our own malloc hooks so operator new
+    // isn't counted twice
+    inline void* rawAllocate(std::size_t size)
+    {
+       #if VOXPROC_RTCHECK_INTERPOSE
+        return __libc_malloc(size);
+       #else
+        return std::malloc(size);
+       #endif
+    }
+
+    inline void rawFree(void* ptr)
+    {
+       #if VOXPROC_RTCHECK_INTERPOSE
+        __libc_free(ptr);
+       #else
+        std::free(ptr);
+       #endif
+    }
+
+    void* allocateOrThrow(std::size_t size)
+    {
+        noteAllocation();
+
+        if (void* ptr = rawAllocate(size == 0 ? 1 : size))
+            return ptr;
+
+        throw std::bad_alloc();
+    }
+
+    // Over-aligned allocations keep the original pointer just before the block
+    void* allocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        noteAllocation();
+
+        const auto align = static_cast<std::size_t>(alignment);
+        void* raw = rawAllocate(size + align + sizeof(void*));
+        if (raw == nullptr)
+            return nullptr;
+
+        auto address = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+        address = (address + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1);
+
+        void* aligned = reinterpret_cast<void*>(address);
+        static_cast<void**>(aligned)[-1] = raw;
+        return aligned;
+    }
+
+    void freeAligned(void* ptr)
+    {
+        if (ptr == nullptr)
+            return;
+
+        noteDeallocation();
+        rawFree(static_cast<void**>(ptr)[-1]);
+    }
+
+    void freeUnaligned(void* ptr)
+    {
+        if (ptr == nullptr)
+            return;
+
+        noteDeallocation();
+        rawFree(ptr);
+    }
+}
+
+namespace RealtimeCheck
+{
+    ScopedRealtimeSection::ScopedRealtimeSection()  { ++sectionDepth; }
+    ScopedRealtimeSection::~ScopedRealtimeSection() { --sectionDepth; }
+
+    Violations getViolations() { return violations; }
+    void resetViolations()     { violations = Violations(); }
+
+    bool hooksCAllocatorAndMutexes() { return VOXPROC_RTCHECK_INTERPOSE != 0; }
+}
+
+//==============================================================================
+// Replaceable global operator new/delete
+//==============================================================================
+void* operator new(std::size_t size)   { return allocateOrThrow(size); }
+void* operator new[](std::size_t size) { return allocateOrThrow(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    noteAllocation();
+    return rawAllocate(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    noteAllocation();
+    return rawAllocate(size == 0 ? 1 : size);
+}
+
+void operator delete(void* ptr) noexcept                          { freeUnaligned(ptr); }
+void operator delete[](void* ptr) noexcept                        { freeUnaligned(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept             { freeUnaligned(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept           { freeUnaligned(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept   { freeUnaligned(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { freeUnaligned(ptr); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void* ptr = allocateAligned(size, alignment))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    if (void* ptr = allocateAligned(size, alignment))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept                { freeAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept              { freeAligned(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept   { freeAligned(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { freeAligned(ptr); }
+
+#if VOXPROC_RTCHECK_INTERPOSE
+//==============================================================================
+// glibc interposition: the executable's definitions take precedence over libc
+// for every shared library, including JUCE's own calls
+//==============================================================================
+namespace
+{
+    using MutexFn = int (*)(pthread_mutex_t*);
+
+    // Resolved without function-local statics: their guards may lock a mutex
+    std::atomic<MutexFn> realMutexLock { nullptr };
+    std::atomic<MutexFn> realMutexTryLock { nullptr };
+
+    MutexFn resolve(std::atomic<MutexFn>& cache, const char* name)
+    {
+        auto fn = cache.load(std::memory_order_acquire);
+        if (fn == nullptr)
+        {
+            fn = reinterpret_cast<MutexFn>(dlsym(RTLD_NEXT, name));
+            cache.store(fn, std::memory_order_release);
+        }
+        return fn;
+    }
+
+    // Resolve at start-up so the first lock on the audio thread doesn't do it
+    [[maybe_unused]] const bool mutexHooksResolved = resolve(realMutexLock, "pthread_mutex_lock") != nullptr
+                                 && resolve(realMutexTryLock, "pthread_mutex_trylock") != nullptr;
+}
+
+extern "C"
+{
+    void* malloc(size_t size)
+    {
+        noteAllocation();
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        noteAllocation();
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* ptr, size_t size)
+    {
+        noteAllocation();
+        return __libc_realloc(ptr, size);
+    }
+
+    // glibc has no __libc_ entry points for the standard aligned allocators;
+    // they all end up in memalign
+    void* memalign(size_t alignment, size_t size)
+    {
+        noteAllocation();
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size)
+    {
+        noteAllocation();
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size)
+    {
+        noteAllocation();
+
+        if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+
+        void* ptr = __libc_memalign(alignment, size);
+        if (ptr == nullptr)
+            return ENOMEM;
+
+        *result = ptr;
+        return 0;
+    }
+
+    void free(void* ptr)
+    {
+        if (ptr != nullptr)
+            noteDeallocation();
+
+        __libc_free(ptr);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        if (sectionDepth > 0)
+            ++violations.mutexLocks;
+
+        return resolve(realMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_mutex_trylock(pthread_mutex_t* mutex)
+    {
+        if (sectionDepth > 0)
+            ++violations.mutexLocks;
+
+        return resolve(realMutexTryLock, "pthread_mutex_trylock")(mutex);
+    }
+}
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+// RealtimeCheck - catches heap allocation and mutex locking on the audio thread
+//
+// While a ScopedRealtimeSection is alive on a thread, every operator new/delete,
+// malloc/calloc/realloc/free, aligned allocation (posix_memalign, aligned_alloc,
+// memalign) and pthread_mutex_lock/trylock made by that thread is counted. Other threads (the plugin's background thread, the message
+// thread) are not affected.
+//
+// operator new/delete are hooked on all platforms. The C allocator and mutex
+// hooks interpose the glibc symbols and are only available on Linux.
+
+namespace RealtimeCheck
+{
+    struct Violations
+    {
+        int allocations = 0;
+        int deallocations = 0;
+        int mutexLocks = 0;
+
+        bool any() const { return allocations + deallocations + mutexLocks > 0; }
+    };
+
+    class ScopedRealtimeSection
+    {
+    public:
+        ScopedRealtimeSection();
+        ~ScopedRealtimeSection();
+
+        ScopedRealtimeSection(const ScopedRealtimeSection&) = delete;
+        ScopedRealtimeSection& operator=(const ScopedRealtimeSection&) = delete;
+    };
+
+    // Counts for the calling thread since the last reset
+    Violations getViolations();
+    void resetViolations();
+
+    // True when the malloc and mutex hooks are active (not just operator new)
+    bool hooksCAllocatorAndMutexes();
+}
@@ -0,0 +1,221 @@
+// VoxProcRender - headless offline renderer
+//
+// Streams a WAV file through VoxProcAudioProcessor::processBlock in fixed-size
+// blocks (no editor is ever created) and writes the processed result.
+//
+// Usage:
+//   VoxProcRender <input.wav> <output.wav> [--preset <file>] [--block <samples>] [--bits <16|24|32>]
+//
+// The preset may be either an XML state (as saved by the plugin's APVTS) or the
+// binary blob returned by getStateInformation().
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+
+namespace
+{
+    struct RenderOptions
+    {
+        juce::File inputFile;
+        juce::File outputFile;
+        juce::File presetFile;
+        int blockSize = 512;
+        int bitsPerSample = 24;
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: VoxProcRender <input.wav> <output.wav> [--preset <file>] [--block <samples>] [--bits <16|24|32>]"
+                  << std::endl;
+    }
+
+    bool parseArguments(const juce::StringArray& args, RenderOptions& options)
+    {
+        juce::StringArray positional;
+
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+
+            if ((arg == "--preset" || arg == "--block" || arg == "--bits") && i + 1 >= args.size())
+                return false;
+
+            if (arg == "--preset")
+                options.presetFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+            else if (arg == "--block")
+                options.blockSize = args[++i].getIntValue();
+            else if (arg == "--bits")
+                options.bitsPerSample = args[++i].getIntValue();
+            else
+                positional.add(arg);
+        }
+
+        if (positional.size() != 2 || options.blockSize <= 0)
+            return false;
+
+        if (options.bitsPerSample != 16 && options.bitsPerSample != 24 && options.bitsPerSample != 32)
+            return false;
+
+        options.inputFile = juce::File::getCurrentWorkingDirectory().getChildFile(positional[0]);
+        options.outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(positional[1]);
+        return true;
+    }
+
+    // Loads either an XML parameter state or a binary state blob into the processor
+    bool loadPreset(VoxProcAudioProcessor& processor, const juce::File& presetFile)
+    {
+        if (! presetFile.existsAsFile())
+            return false;
+
+        juce::MemoryBlock stateData;
+
+        if (auto xml = juce::parseXML(presetFile))
+            juce::AudioProcessor::copyXmlToBinary(*xml, stateData);
+        else if (! presetFile.loadFileAsData(stateData))
+            return false;
+
+        processor.setStateInformation(stateData.getData(), static_cast<int>(stateData.getSize()));
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    RenderOptions options;
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::String::fromUTF8(argv[i]));
+
+    if (! parseArguments(args, options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(options.inputFile));
+    if (reader == nullptr)
+    {
+        std::cerr << "Could not open input file: " << options.inputFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    const int numChannels = static_cast<int>(reader->numChannels);
+    const double sampleRate = reader->sampleRate;
+    const juce::int64 totalSamples = reader->lengthInSamples;
+
+    if (numChannels < 1 || numChannels > 2)
+    {
+        std::cerr << "Only mono and stereo files are supported (got " << numChannels << " channels)" << std::endl;
+        return 1;
+    }
+
+    VoxProcAudioProcessor processor;
+
+    // Match the processor's bus layout to the file
+    const auto channelSet = numChannels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+
+    if (! processor.setBusesLayout(layout))
+    {
+        std::cerr << "Processor rejected the " << channelSet.getDescription() << " layout" << std::endl;
+        return 1;
+    }
+
+    if (options.presetFile != juce::File() && ! loadPreset(processor, options.presetFile))
+    {
+        std::cerr << "Could not load preset: " << options.presetFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    processor.setNonRealtime(true);
+    processor.setRateAndBufferSizeDetails(sampleRate, options.blockSize);
+    processor.prepareToPlay(sampleRate, options.blockSize);
+
+    options.outputFile.deleteFile();
+    std::unique_ptr<juce::OutputStream> outputStream = std::make_unique<juce::FileOutputStream>(options.outputFile);
+    if (static_cast<juce::FileOutputStream*>(outputStream.get())->failedToOpen())
+    {
+        std::cerr << "Could not create output file: " << options.outputFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    juce::WavAudioFormat wavFormat;
+    auto writerOptions = juce::AudioFormatWriterOptions{}.withSampleRate(sampleRate)
+                                                         .withNumChannels(numChannels)
+                                                         .withBitsPerSample(options.bitsPerSample);
+    std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(outputStream, writerOptions));
+    if (writer == nullptr)
+    {
+        std::cerr << "Could not create WAV writer" << std::endl;
+        return 1;
+    }
+
+    // Output is delayed by the reported latency: feed that many extra samples of
+    // silence at the end and drop the same amount from the start
+    const int latency = processor.getLatencySamples();
+    const juce::int64 samplesToProcess = totalSamples + latency;
+
+    juce::AudioBuffer<float> buffer(numChannels, options.blockSize);
+    juce::MidiBuffer midi;
+
+    juce::int64 samplesRead = 0;
+    juce::int64 samplesToSkip = latency;
+    juce::int64 processTicks = 0;
+
+    const auto renderStart = juce::Time::getHighResolutionTicks();
+
+    while (samplesRead < samplesToProcess)
+    {
+        const int numThisTime = static_cast<int>(std::min<juce::int64>(options.blockSize, samplesToProcess - samplesRead));
+
+        buffer.clear();
+        if (samplesRead < totalSamples)
+        {
+            const int numFromFile = static_cast<int>(std::min<juce::int64>(numThisTime, totalSamples - samplesRead));
+            reader->read(&buffer, 0, numFromFile, samplesRead, true, numChannels > 1);
+        }
+
+        // Final partial block is passed with its real length, as a host would
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, numThisTime);
+
+        const auto blockStart = juce::Time::getHighResolutionTicks();
+        processor.processBlock(block, midi);
+        processTicks += juce::Time::getHighResolutionTicks() - blockStart;
+
+        const int skip = static_cast<int>(std::min<juce::int64>(samplesToSkip, numThisTime));
+        samplesToSkip -= skip;
+
+        if (skip < numThisTime)
+            writer->writeFromAudioSampleBuffer(block, skip, numThisTime - skip);
+
+        samplesRead += numThisTime;
+    }
+
+    const auto renderTicks = juce::Time::getHighResolutionTicks() - renderStart;
+
+    writer.reset();
+    processor.releaseResources();
+
+    const double audioSeconds = static_cast<double>(totalSamples) / sampleRate;
+    const double processSeconds = juce::Time::highResolutionTicksToSeconds(processTicks);
+    const double renderSeconds = juce::Time::highResolutionTicksToSeconds(renderTicks);
+
+    std::cout << options.inputFile.getFileName() << " -> " << options.outputFile.getFileName() << std::endl;
+    std::cout << "  " << numChannels << " ch, " << sampleRate << " Hz, block " << options.blockSize
+              << ", latency " << latency << " samples" << std::endl;
+    std::cout << "  audio:   " << juce::String(audioSeconds, 3) << " s" << std::endl;
+    std::cout << "  process: " << juce::String(processSeconds, 3) << " s ("
+              << juce::String(processSeconds > 0.0 ? audioSeconds / processSeconds : 0.0, 1) << "x real time)" << std::endl;
+    std::cout << "  total:   " << juce::String(renderSeconds, 3) << " s ("
+              << juce::String(renderSeconds > 0.0 ? audioSeconds / renderSeconds : 0.0, 1) << "x real time, including file I/O)"
+              << std::endl;
+
+    return 0;
+}